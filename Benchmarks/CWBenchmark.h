@@ -0,0 +1,183 @@
+/*
+//  CWBenchmark.h
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/**
+ The pattern a generated workload follows
+ 
+ Uniform & Zipf workloads mix 45% inserts, 45% removes & 10% lookups with keys
+ drawn uniformly or from a Zipf distribution (s = 0.99) over the key space.
+ Burst workloads alternate runs of 256 inserts with runs of 256 removes using
+ uniformly drawn keys.
+ */
+typedef NS_ENUM(NSUInteger, CWBenchmarkPattern) {
+	CWBenchmarkPatternUniform,
+	CWBenchmarkPatternZipf,
+	CWBenchmarkPatternBurst
+};
+
+typedef NS_ENUM(uint8_t, CWBenchmarkOperation) {
+	CWBenchmarkOperationInsert,
+	CWBenchmarkOperationRemove,
+	CWBenchmarkOperationLookup
+};
+
+/**
+ A precomputed sequence of operations & keys
+ 
+ Workloads are generated before timing starts so random number generation is
+ never part of a measurement. The same seed always generates the same workload
+ so runs can be compared with each other.
+ */
+@interface CWBenchmarkWorkload : NSObject
+
+-(instancetype)initWithPattern:(CWBenchmarkPattern)pattern
+					operations:(NSUInteger)count
+					  keySpace:(NSUInteger)keySpace;
+
++(NSString *)nameForPattern:(CWBenchmarkPattern)pattern;
+
+@property(readonly) CWBenchmarkPattern pattern;
+@property(readonly) NSUInteger count;
+@property(readonly) NSUInteger keySpace;
+@property(readonly) const CWBenchmarkOperation *operations;
+@property(readonly) const uint32_t *keys;
+
+@end
+
+typedef void (^CWBenchmarkOperationBlock)(id context, CWBenchmarkOperation operation, uint32_t key);
+
+/**
+ Runs benchmarks and collects their results
+ 
+ Options are read from the command line with NSUserDefaults:
+ 
+ -sizes 100,10000,1000000  structure sizes to run (up to 10000000)
+ -maxOperations 1000000    operations per operation mix benchmark
+ -threads N                threads for contended benchmarks (default: cores)
+ -filter CWTrie            only run benchmarks whose name contains this
+ -output results.json      write the JSON results here instead of stdout
+ */
+@interface CWBenchmarkRunner : NSObject
+
+-(instancetype)initWithUserDefaults:(NSUserDefaults *)defaults;
+
+@property(readonly) NSArray *sizes;
+@property(readonly) NSUInteger maxOperations;
+@property(readonly) NSUInteger threads;
+
+/**
+ Returns the configured sizes that are no larger than limit
+ 
+ Some structures have operations that are linear in their size, these cap the
+ sizes they run at so a full run finishes in reasonable time.
+ */
+-(NSArray *)sizesUpTo:(NSUInteger)limit;
+
+/**
+ Returns if benchmarks named name should be run given the -filter option
+ */
+-(BOOL)shouldRunBenchmarkNamed:(NSString *)name;
+
+/**
+ Returns NSNumber keys 0..<keySpace, shared between benchmarks
+ */
+-(NSArray *)numberKeysForKeySpace:(NSUInteger)keySpace;
+
+/**
+ Returns NSString keys for 0..<keySpace, shared between benchmarks
+ */
+-(NSArray *)stringKeysForKeySpace:(NSUInteger)keySpace;
+
+/**
+ Runs workload against the context returned by setup on threads threads
+ 
+ Each thread runs an equal slice of the workload. The latency of individual
+ operations is sampled to compute percentiles. The context is released before
+ the next benchmark runs.
+ */
+-(void)runBenchmark:(NSString *)name
+		   workload:(CWBenchmarkWorkload *)workload
+			   size:(NSUInteger)size
+			threads:(NSUInteger)threads
+			  setup:(id (^)(void))setup
+		  operation:(CWBenchmarkOperationBlock)operation;
+
+/**
+ Times a single call of body against the context returned by setup
+ 
+ This is for benchmarks that measure a whole build or traversal rather than
+ individual operations. operations is the number of elements body processes &
+ is used to compute ops/sec & allocations per operation. body may return extra
+ metrics to be included in the result.
+ */
+-(void)runBenchmark:(NSString *)name
+			variant:(NSString *)variant
+			   size:(NSUInteger)size
+		 operations:(NSUInteger)operations
+			  setup:(id (^)(void))setup
+			   body:(NSDictionary *(^)(id context))body;
+
+/**
+ Times creating & destroying instances returned by create
+ 
+ Creates as many instances as -maxOperations allows (up to 100000), holding
+ them all before releasing them so the result also reports the bytes each
+ live instance takes up.
+ */
+-(void)runCreationBenchmark:(NSString *)name
+					variant:(NSString *)variant
+					 create:(id (^)(void))create;
+
+/**
+ Returns all results collected so far as JSON
+ */
+-(NSData *)JSONData;
+
+@end
+
+/**
+ Prints a comparison of two JSON result files written by the benchmark tool
+ 
+ @return 0 on success, 1 if either file could not be read
+ */
+int CWBenchmarkCompareResults(NSString *basePath, NSString *newPath);
+
+/**
+ Benchmark suites, one per group of data structures
+ */
+void CWRunQueueBenchmarks(CWBenchmarkRunner *runner);
+void CWRunDurableQueueBenchmarks(CWBenchmarkRunner *runner);
+void CWRunTrieBenchmarks(CWBenchmarkRunner *runner);
+void CWRunTreeBenchmarks(CWBenchmarkRunner *runner);
+void CWRunWorkStealingDequeBenchmarks(CWBenchmarkRunner *runner);
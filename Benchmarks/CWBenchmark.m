@@ -0,0 +1,531 @@
+/*
+//  CWBenchmark.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWBenchmark.h"
+#import "CWBenchmarkAllocations.h"
+#include <math.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#define kCWBenchmarkDefaultSizes @"100,10000,1000000"
+#define kCWBenchmarkDefaultMaxOperations 1000000
+#define kCWBenchmarkMaxLatencySamples (1 << 20)
+#define kCWBenchmarkBurstLength 256
+#define kCWBenchmarkZipfExponent 0.99
+//shared key objects are capped so huge sizes don't spend their memory on keys
+#define kCWBenchmarkMaxKeySpace (1 << 20)
+//operations between autorelease pool drains
+#define kCWBenchmarkPoolInterval 4096
+#define kCWBenchmarkMaxCreations 100000
+
+#pragma mark Utilities -
+
+static inline uint64_t CWBenchmarkNow(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t CWBenchmarkRandom(uint64_t *state) {
+	//splitmix64
+	uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+static int CWBenchmarkCompareSamples(const void *a, const void *b) {
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ Resets the peak resident set size on Linux so each benchmark reports its own
+ peak. Elsewhere the peak only ever grows over the life of the process.
+ */
+static void CWBenchmarkResetPeakRSS(void) {
+	FILE *file = fopen("/proc/self/clear_refs", "w");
+	if (file == NULL) return;
+	fputs("5", file);
+	fclose(file);
+}
+
+static uint64_t CWBenchmarkPeakRSSBytes(void) {
+	FILE *file = fopen("/proc/self/status", "r");
+	if (file) {
+		char line[256];
+		unsigned long long kilobytes = 0;
+		while (fgets(line, sizeof(line), file)) {
+			if (sscanf(line, "VmHWM: %llu kB", &kilobytes) == 1) break;
+		}
+		fclose(file);
+		if (kilobytes > 0) return kilobytes * 1024;
+	}
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+	return (uint64_t)usage.ru_maxrss;
+#else
+	return (uint64_t)usage.ru_maxrss * 1024;
+#endif
+}
+
+#pragma mark Workloads -
+
+@implementation CWBenchmarkWorkload {
+	CWBenchmarkOperation *_operations;
+	uint32_t *_keys;
+}
+
+-(instancetype)initWithPattern:(CWBenchmarkPattern)pattern
+					operations:(NSUInteger)count
+					  keySpace:(NSUInteger)keySpace {
+	self = [super init];
+	if (self == nil) return nil;
+	
+	_pattern = pattern;
+	_count = count;
+	_keySpace = MAX(keySpace, (NSUInteger)1);
+	_operations = malloc(MAX(count, (NSUInteger)1) * sizeof(CWBenchmarkOperation));
+	_keys = malloc(MAX(count, (NSUInteger)1) * sizeof(uint32_t));
+	
+	uint64_t state = 0x5a4e47455453550AULL ^ (uint64_t)pattern;
+	double *zipfCDF = NULL;
+	if (pattern == CWBenchmarkPatternZipf) {
+		zipfCDF = malloc(_keySpace * sizeof(double));
+		double total = 0.0;
+		for (NSUInteger i = 0; i < _keySpace; i++) {
+			total += 1.0 / pow((double)(i + 1), kCWBenchmarkZipfExponent);
+			zipfCDF[i] = total;
+		}
+		for (NSUInteger i = 0; i < _keySpace; i++) zipfCDF[i] /= total;
+	}
+	
+	for (NSUInteger i = 0; i < count; i++) {
+		uint64_t random = CWBenchmarkRandom(&state);
+		if (pattern == CWBenchmarkPatternBurst) {
+			_operations[i] = ((i / kCWBenchmarkBurstLength) % 2 == 0) ? CWBenchmarkOperationInsert : CWBenchmarkOperationRemove;
+		} else {
+			uint64_t mix = random % 100;
+			_operations[i] = (mix < 45) ? CWBenchmarkOperationInsert : ((mix < 90) ? CWBenchmarkOperationRemove : CWBenchmarkOperationLookup);
+		}
+		
+		uint64_t keyRandom = CWBenchmarkRandom(&state);
+		if (zipfCDF) {
+			double target = (double)(keyRandom >> 11) / (double)(1ULL << 53);
+			NSUInteger low = 0, high = _keySpace - 1;
+			while (low < high) {
+				NSUInteger middle = (low + high) / 2;
+				if (zipfCDF[middle] < target) {
+					low = middle + 1;
+				} else {
+					high = middle;
+				}
+			}
+			_keys[i] = (uint32_t)low;
+		} else {
+			_keys[i] = (uint32_t)(keyRandom % _keySpace);
+		}
+	}
+	free(zipfCDF);
+	
+	return self;
+}
+
+-(void)dealloc {
+	free(_operations);
+	free(_keys);
+}
+
+-(const CWBenchmarkOperation *)operations {
+	return _operations;
+}
+
+-(const uint32_t *)keys {
+	return _keys;
+}
+
++(NSString *)nameForPattern:(CWBenchmarkPattern)pattern {
+	switch (pattern) {
+		case CWBenchmarkPatternUniform: return @"uniform";
+		case CWBenchmarkPatternZipf: return @"zipf";
+		case CWBenchmarkPatternBurst: return @"burst";
+	}
+	return @"unknown";
+}
+
+@end
+
+#pragma mark Threads -
+
+/**
+ The state of one benchmark thread, passed to pthread_create
+ */
+@interface CWBenchmarkSlice : NSObject {
+@public
+	id _context;
+	CWBenchmarkOperationBlock _operation;
+	const CWBenchmarkOperation *_operations;
+	const uint32_t *_keys;
+	NSUInteger _begin;
+	NSUInteger _end;
+	NSUInteger _sampleStride;
+	uint64_t *_samples;
+	NSUInteger _sampleCount;
+	uint64_t _allocations;
+	volatile int *_go;
+}
+@end
+
+@implementation CWBenchmarkSlice
+
+-(void)run {
+	while (!__atomic_load_n(_go, __ATOMIC_ACQUIRE)) { }
+	
+	uint64_t allocationsBefore = CWBenchmarkThreadAllocationCount();
+	NSUInteger untilSample = 0;
+	NSUInteger i = _begin;
+	while (i < _end) {
+		@autoreleasepool {
+			NSUInteger chunkEnd = MIN(i + kCWBenchmarkPoolInterval, _end);
+			for (; i < chunkEnd; i++) {
+				if (untilSample == 0) {
+					uint64_t start = CWBenchmarkNow();
+					_operation(_context, _operations[i], _keys[i]);
+					_samples[_sampleCount++] = CWBenchmarkNow() - start;
+					untilSample = _sampleStride - 1;
+				} else {
+					_operation(_context, _operations[i], _keys[i]);
+					untilSample--;
+				}
+			}
+		}
+	}
+	_allocations = CWBenchmarkThreadAllocationCount() - allocationsBefore;
+}
+
+@end
+
+static void *CWBenchmarkThreadMain(void *argument) {
+	@autoreleasepool {
+		CWBenchmarkSlice *slice = (__bridge CWBenchmarkSlice *)argument;
+		[slice run];
+	}
+	return NULL;
+}
+
+#pragma mark Runner -
+
+@interface CWBenchmarkRunner ()
+@property(strong) NSMutableArray *results;
+@property(strong) NSString *filter;
+@property(strong) NSMutableDictionary *numberKeys;
+@property(strong) NSMutableDictionary *stringKeys;
+@end
+
+@implementation CWBenchmarkRunner
+
+-(instancetype)initWithUserDefaults:(NSUserDefaults *)defaults {
+	self = [super init];
+	if (self == nil) return nil;
+	
+	NSString *sizes = [defaults stringForKey:@"sizes"] ?: kCWBenchmarkDefaultSizes;
+	NSMutableArray *parsedSizes = [NSMutableArray array];
+	for (NSString *size in [sizes componentsSeparatedByString:@","]) {
+		long long value = [size longLongValue];
+		if (value > 0) [parsedSizes addObject:@((NSUInteger)value)];
+	}
+	_sizes = parsedSizes;
+	
+	NSInteger maxOperations = [defaults integerForKey:@"maxOperations"];
+	_maxOperations = (maxOperations > 0) ? (NSUInteger)maxOperations : kCWBenchmarkDefaultMaxOperations;
+	NSInteger threads = [defaults integerForKey:@"threads"];
+	_threads = (threads > 0) ? (NSUInteger)threads : [[NSProcessInfo processInfo] activeProcessorCount];
+	_filter = [defaults stringForKey:@"filter"];
+	_results = [NSMutableArray array];
+	_numberKeys = [NSMutableDictionary dictionary];
+	_stringKeys = [NSMutableDictionary dictionary];
+	
+	return self;
+}
+
+-(NSArray *)sizesUpTo:(NSUInteger)limit {
+	NSMutableArray *sizes = [NSMutableArray array];
+	for (NSNumber *size in self.sizes) {
+		if (size.unsignedIntegerValue <= limit) [sizes addObject:size];
+	}
+	return sizes;
+}
+
+-(BOOL)shouldRunBenchmarkNamed:(NSString *)name {
+	if (self.filter.length == 0) return YES;
+	return [name rangeOfString:self.filter].location != NSNotFound;
+}
+
+-(NSArray *)numberKeysForKeySpace:(NSUInteger)keySpace {
+	keySpace = MIN(MAX(keySpace, (NSUInteger)1), (NSUInteger)kCWBenchmarkMaxKeySpace);
+	NSArray *keys = self.numberKeys[@(keySpace)];
+	if (keys) return keys;
+	NSMutableArray *newKeys = [NSMutableArray arrayWithCapacity:keySpace];
+	for (NSUInteger i = 0; i < keySpace; i++) [newKeys addObject:@(i)];
+	self.numberKeys[@(keySpace)] = newKeys;
+	return newKeys;
+}
+
+-(NSArray *)stringKeysForKeySpace:(NSUInteger)keySpace {
+	keySpace = MIN(MAX(keySpace, (NSUInteger)1), (NSUInteger)kCWBenchmarkMaxKeySpace);
+	NSArray *keys = self.stringKeys[@(keySpace)];
+	if (keys) return keys;
+	NSMutableArray *newKeys = [NSMutableArray arrayWithCapacity:keySpace];
+	for (NSUInteger i = 0; i < keySpace; i++) {
+		[newKeys addObject:[NSString stringWithFormat:@"key%lu", (unsigned long)i]];
+	}
+	self.stringKeys[@(keySpace)] = newKeys;
+	return newKeys;
+}
+
+-(void)_logResult:(NSDictionary *)result {
+	fprintf(stderr, "%-40s %-10s threads:%-3lu size:%-9lu %14.0f ops/sec\n",
+			[result[@"name"] UTF8String],
+			[result[@"workload"] UTF8String],
+			(unsigned long)[result[@"threads"] unsignedIntegerValue],
+			(unsigned long)[result[@"size"] unsignedIntegerValue],
+			[result[@"opsPerSec"] doubleValue]);
+}
+
+-(void)runBenchmark:(NSString *)name
+		   workload:(CWBenchmarkWorkload *)workload
+			   size:(NSUInteger)size
+			threads:(NSUInteger)threads
+			  setup:(id (^)(void))setup
+		  operation:(CWBenchmarkOperationBlock)operation {
+	if (![self shouldRunBenchmarkNamed:name]) return;
+	threads = MAX(threads, (NSUInteger)1);
+	
+	NSDictionary *result = nil;
+	@autoreleasepool {
+		CWBenchmarkResetPeakRSS();
+		id context = setup();
+		
+		NSUInteger sampleStride = MAX((NSUInteger)1, workload.count / kCWBenchmarkMaxLatencySamples);
+		NSUInteger perThread = workload.count / threads;
+		volatile int go = 0;
+		NSMutableArray *slices = [NSMutableArray arrayWithCapacity:threads];
+		for (NSUInteger t = 0; t < threads; t++) {
+			CWBenchmarkSlice *slice = [CWBenchmarkSlice new];
+			slice->_context = context;
+			slice->_operation = operation;
+			slice->_operations = workload.operations;
+			slice->_keys = workload.keys;
+			slice->_begin = t * perThread;
+			slice->_end = (t == threads - 1) ? workload.count : (t + 1) * perThread;
+			slice->_sampleStride = sampleStride;
+			slice->_samples = malloc(((slice->_end - slice->_begin) / sampleStride + 1) * sizeof(uint64_t));
+			slice->_sampleCount = 0;
+			slice->_go = &go;
+			[slices addObject:slice];
+		}
+		
+		uint64_t start = 0;
+		if (threads == 1) {
+			CWBenchmarkSlice *slice = slices[0];
+			go = 1;
+			start = CWBenchmarkNow();
+			[slice run];
+		} else {
+			pthread_t *handles = malloc(threads * sizeof(pthread_t));
+			for (NSUInteger t = 0; t < threads; t++) {
+				pthread_create(&handles[t], NULL, CWBenchmarkThreadMain, (__bridge void *)slices[t]);
+			}
+			start = CWBenchmarkNow();
+			__atomic_store_n(&go, 1, __ATOMIC_RELEASE);
+			for (NSUInteger t = 0; t < threads; t++) pthread_join(handles[t], NULL);
+			free(handles);
+		}
+		uint64_t elapsed = CWBenchmarkNow() - start;
+		
+		NSUInteger sampleCount = 0;
+		uint64_t allocations = 0;
+		for (CWBenchmarkSlice *slice in slices) {
+			sampleCount += slice->_sampleCount;
+			allocations += slice->_allocations;
+		}
+		uint64_t *samples = malloc(MAX(sampleCount, (NSUInteger)1) * sizeof(uint64_t));
+		NSUInteger offset = 0;
+		for (CWBenchmarkSlice *slice in slices) {
+			memcpy(samples + offset, slice->_samples, slice->_sampleCount * sizeof(uint64_t));
+			offset += slice->_sampleCount;
+			free(slice->_samples);
+			slice->_context = nil;
+		}
+		qsort(samples, sampleCount, sizeof(uint64_t), CWBenchmarkCompareSamples);
+		NSDictionary *latency = @{};
+		if (sampleCount > 0) {
+			latency = @{ @"p50" : @(samples[sampleCount / 2]),
+						 @"p99" : @(samples[(sampleCount * 99) / 100]),
+						 @"p999" : @(samples[(sampleCount * 999) / 1000]) };
+		}
+		free(samples);
+		
+		result = @{ @"name" : name,
+					@"workload" : [CWBenchmarkWorkload nameForPattern:workload.pattern],
+					@"threads" : @(threads),
+					@"size" : @(size),
+					@"operations" : @(workload.count),
+					@"seconds" : @((double)elapsed / 1e9),
+					@"opsPerSec" : @((double)workload.count / ((double)elapsed / 1e9)),
+					@"latencyNs" : latency,
+					@"allocationsPerOp" : (CWBenchmarkAllocationCountingAvailable() ?
+										   (id)@((double)allocations / (double)MAX(workload.count, (NSUInteger)1)) :
+										   (id)[NSNull null]),
+					@"peakRSSBytes" : @(CWBenchmarkPeakRSSBytes()) };
+		context = nil;
+	}
+	[self.results addObject:result];
+	[self _logResult:result];
+}
+
+-(void)runBenchmark:(NSString *)name
+			variant:(NSString *)variant
+			   size:(NSUInteger)size
+		 operations:(NSUInteger)operations
+			  setup:(id (^)(void))setup
+			   body:(NSDictionary *(^)(id context))body {
+	if (![self shouldRunBenchmarkNamed:name]) return;
+	
+	NSMutableDictionary *result = nil;
+	@autoreleasepool {
+		CWBenchmarkResetPeakRSS();
+		id context = setup ? setup() : nil;
+		uint64_t allocationsBefore = CWBenchmarkThreadAllocationCount();
+		uint64_t start = CWBenchmarkNow();
+		NSDictionary *extra = body(context);
+		uint64_t elapsed = CWBenchmarkNow() - start;
+		uint64_t allocations = CWBenchmarkThreadAllocationCount() - allocationsBefore;
+		
+		result = [@{ @"name" : name,
+					 @"workload" : variant,
+					 @"threads" : @1,
+					 @"size" : @(size),
+					 @"operations" : @(operations),
+					 @"seconds" : @((double)elapsed / 1e9),
+					 @"opsPerSec" : @((double)operations / ((double)elapsed / 1e9)),
+					 @"allocationsPerOp" : (CWBenchmarkAllocationCountingAvailable() ?
+											(id)@((double)allocations / (double)MAX(operations, (NSUInteger)1)) :
+											(id)[NSNull null]),
+					 @"peakRSSBytes" : @(CWBenchmarkPeakRSSBytes()) } mutableCopy];
+		if (extra) [result addEntriesFromDictionary:extra];
+		context = nil;
+	}
+	[self.results addObject:result];
+	[self _logResult:result];
+}
+
+-(void)runCreationBenchmark:(NSString *)name
+					variant:(NSString *)variant
+					 create:(id (^)(void))create {
+	NSUInteger count = MIN(self.maxOperations, (NSUInteger)kCWBenchmarkMaxCreations);
+	[self runBenchmark:name variant:variant size:count operations:count setup:nil body:^NSDictionary *(id context) {
+		__strong id *instances = (__strong id *)calloc(count, sizeof(id));
+		int64_t bytesBefore = CWBenchmarkThreadLiveBytes();
+		@autoreleasepool {
+			for (NSUInteger i = 0; i < count; i++) instances[i] = create();
+		}
+		int64_t bytes = CWBenchmarkThreadLiveBytes() - bytesBefore;
+		for (NSUInteger i = 0; i < count; i++) instances[i] = nil;
+		free(instances);
+		if (!CWBenchmarkAllocationCountingAvailable()) return nil;
+		return @{ @"bytesPerInstance" : @((double)bytes / (double)count) };
+	}];
+}
+
+-(NSData *)JSONData {
+	NSDictionary *report = @{ @"tool" : @"CWBenchmark",
+							  @"date" : [[NSDate date] description],
+							  @"processors" : @([[NSProcessInfo processInfo] activeProcessorCount]),
+							  @"allocationCounting" : @(CWBenchmarkAllocationCountingAvailable()),
+							  @"results" : self.results };
+	return [NSJSONSerialization dataWithJSONObject:report
+										   options:NSJSONWritingPrettyPrinted
+											 error:NULL];
+}
+
+@end
+
+#pragma mark Comparison -
+
+static NSString *CWBenchmarkResultKey(NSDictionary *result) {
+	return [NSString stringWithFormat:@"%@ %@ threads:%@ size:%@",
+			result[@"name"], result[@"workload"], result[@"threads"], result[@"size"]];
+}
+
+static NSDictionary *CWBenchmarkLoadResults(NSString *path) {
+	NSData *data = [NSData dataWithContentsOfFile:path];
+	if (data == nil) return nil;
+	NSDictionary *report = [NSJSONSerialization JSONObjectWithData:data options:0 error:NULL];
+	if (![report isKindOfClass:[NSDictionary class]]) return nil;
+	NSMutableDictionary *results = [NSMutableDictionary dictionary];
+	for (NSDictionary *result in report[@"results"]) {
+		results[CWBenchmarkResultKey(result)] = result;
+	}
+	return results;
+}
+
+int CWBenchmarkCompareResults(NSString *basePath, NSString *newPath) {
+	NSDictionary *base = CWBenchmarkLoadResults(basePath);
+	NSDictionary *new = CWBenchmarkLoadResults(newPath);
+	if (base == nil || new == nil) {
+		fprintf(stderr, "could not read %s\n", [(base ? newPath : basePath) UTF8String]);
+		return 1;
+	}
+	
+	printf("%-72s %14s %14s %9s %9s\n", "benchmark", "base ops/sec", "new ops/sec", "change", "p99");
+	for (NSString *key in [[new allKeys] sortedArrayUsingSelector:@selector(compare:)]) {
+		NSDictionary *newResult = new[key];
+		NSDictionary *baseResult = base[key];
+		if (baseResult == nil) {
+			printf("%-72s %14s %14.0f %9s\n", [key UTF8String], "-", [newResult[@"opsPerSec"] doubleValue], "new");
+			continue;
+		}
+		double baseOps = [baseResult[@"opsPerSec"] doubleValue];
+		double newOps = [newResult[@"opsPerSec"] doubleValue];
+		double baseP99 = [baseResult[@"latencyNs"][@"p99"] doubleValue];
+		double newP99 = [newResult[@"latencyNs"][@"p99"] doubleValue];
+		char p99Change[32] = "-";
+		if (baseP99 > 0) snprintf(p99Change, sizeof(p99Change), "%+.1f%%", ((newP99 / baseP99) - 1.0) * 100.0);
+		printf("%-72s %14.0f %14.0f %+8.1f%% %9s\n", [key UTF8String], baseOps, newOps,
+			   ((newOps / baseOps) - 1.0) * 100.0, p99Change);
+	}
+	return 0;
+}
@@ -0,0 +1,142 @@
+/*
+//  CWBenchmarkAllocations.c
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CWBenchmarkAllocations.h"
+#include <stdlib.h>
+
+#if defined(__GLIBC__)
+
+#include <errno.h>
+#include <malloc.h>
+#include <unistd.h>
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void *ptr);
+
+static __thread uint64_t threadAllocations = 0;
+static __thread int64_t threadLiveBytes = 0;
+
+static inline void *CWBenchmarkCountAllocation(void *ptr) {
+	if (ptr) {
+		threadAllocations++;
+		threadLiveBytes += (int64_t)malloc_usable_size(ptr);
+	}
+	return ptr;
+}
+
+static inline bool CWBenchmarkIsPowerOfTwo(size_t value) {
+	return (value != 0) && ((value & (value - 1)) == 0);
+}
+
+void *malloc(size_t size) {
+	return CWBenchmarkCountAllocation(__libc_malloc(size));
+}
+
+void *calloc(size_t count, size_t size) {
+	return CWBenchmarkCountAllocation(__libc_calloc(count, size));
+}
+
+//the aligned allocators all end up in __libc_memalign, each keeps its own
+//argument checks so callers see the same errors as without the wrappers
+
+void *memalign(size_t alignment, size_t size) {
+	return CWBenchmarkCountAllocation(__libc_memalign(alignment, size));
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size) {
+	if (!CWBenchmarkIsPowerOfTwo(alignment) || (alignment % sizeof(void *)) != 0) return EINVAL;
+	void *newPtr = CWBenchmarkCountAllocation(__libc_memalign(alignment, size));
+	if (newPtr == NULL) return ENOMEM;
+	*ptr = newPtr;
+	return 0;
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+	if (!CWBenchmarkIsPowerOfTwo(alignment)) {
+		errno = EINVAL;
+		return NULL;
+	}
+	return CWBenchmarkCountAllocation(__libc_memalign(alignment, size));
+}
+
+void *valloc(size_t size) {
+	return CWBenchmarkCountAllocation(__libc_memalign((size_t)sysconf(_SC_PAGESIZE), size));
+}
+
+void *realloc(void *ptr, size_t size) {
+	int64_t oldSize = ptr ? (int64_t)malloc_usable_size(ptr) : 0;
+	void *newPtr = __libc_realloc(ptr, size);
+	if (newPtr) {
+		threadAllocations++;
+		threadLiveBytes += (int64_t)malloc_usable_size(newPtr) - oldSize;
+	} else if (size == 0) {
+		threadLiveBytes -= oldSize;
+	}
+	return newPtr;
+}
+
+void free(void *ptr) {
+	if (ptr == NULL) return;
+	threadLiveBytes -= (int64_t)malloc_usable_size(ptr);
+	__libc_free(ptr);
+}
+
+bool CWBenchmarkAllocationCountingAvailable(void) {
+	return true;
+}
+
+uint64_t CWBenchmarkThreadAllocationCount(void) {
+	return threadAllocations;
+}
+
+int64_t CWBenchmarkThreadLiveBytes(void) {
+	return threadLiveBytes;
+}
+
+#else
+
+bool CWBenchmarkAllocationCountingAvailable(void) {
+	return false;
+}
+
+uint64_t CWBenchmarkThreadAllocationCount(void) {
+	return 0;
+}
+
+int64_t CWBenchmarkThreadLiveBytes(void) {
+	return 0;
+}
+
+#endif
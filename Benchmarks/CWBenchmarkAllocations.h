@@ -0,0 +1,68 @@
+/*
+//  CWBenchmarkAllocations.h
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CWBENCHMARKALLOCATIONS_H
+#define CWBENCHMARKALLOCATIONS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ Allocation counting for the benchmark tool
+ 
+ On glibc the tool replaces malloc, calloc, realloc, free & the aligned
+ allocators (memalign, posix_memalign, aligned_alloc & valloc) with wrappers
+ around the __libc_ versions so that allocations made inside Foundation & the
+ Objective-C runtime are counted too. Memory mapped directly with mmap, such as
+ CWQueueSegmentLog segments, is not an allocation & isn't counted. Counters are
+ kept per thread so counting does not add contention to the contended
+ benchmarks.
+ */
+
+/**
+ Returns true if allocations are being counted on this platform
+ */
+bool CWBenchmarkAllocationCountingAvailable(void);
+
+/**
+ Returns the number of allocations made by the calling thread so far
+ */
+uint64_t CWBenchmarkThreadAllocationCount(void);
+
+/**
+ Returns the number of bytes allocated minus the bytes freed by the calling
+ thread so far. Memory freed on a different thread than it was allocated on
+ is subtracted from the freeing thread.
+ */
+int64_t CWBenchmarkThreadLiveBytes(void);
+
+#endif
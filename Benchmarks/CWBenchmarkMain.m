@@ -0,0 +1,77 @@
+/*
+//  CWBenchmarkMain.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWBenchmark.h"
+
+/**
+ Usage:
+ 
+ CWBenchmark [-sizes 100,10000] [-maxOperations N] [-threads N] [-filter name] [-output results.json]
+ CWBenchmark -compare base.json -with new.json
+ 
+ Progress is logged to stderr, the JSON results go to stdout unless -output is given.
+ */
+int main(int argc, const char *argv[]) {
+	@autoreleasepool {
+		NSUserDefaults *defaults = [NSUserDefaults standardUserDefaults];
+		
+		NSString *basePath = [defaults stringForKey:@"compare"];
+		if (basePath) {
+			NSString *newPath = [defaults stringForKey:@"with"];
+			if (newPath == nil) {
+				fprintf(stderr, "usage: CWBenchmark -compare base.json -with new.json\n");
+				return 1;
+			}
+			return CWBenchmarkCompareResults(basePath, newPath);
+		}
+		
+		CWBenchmarkRunner *runner = [[CWBenchmarkRunner alloc] initWithUserDefaults:defaults];
+		CWRunQueueBenchmarks(runner);
+		CWRunDurableQueueBenchmarks(runner);
+		CWRunTrieBenchmarks(runner);
+		CWRunTreeBenchmarks(runner);
+		CWRunWorkStealingDequeBenchmarks(runner);
+		
+		NSData *json = [runner JSONData];
+		NSString *outputPath = [defaults stringForKey:@"output"];
+		if (outputPath) {
+			if (![json writeToFile:outputPath atomically:YES]) {
+				fprintf(stderr, "could not write %s\n", [outputPath UTF8String]);
+				return 1;
+			}
+		} else {
+			fwrite(json.bytes, 1, json.length, stdout);
+			fputc('\n', stdout);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,128 @@
+/*
+//  CWDurableQueueBenchmarks.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWBenchmark.h"
+#import "CWQueue.h"
+#include <unistd.h>
+
+//bytes in each record enqueued by the throughput benchmarks
+#define kCWDurableQueueBenchmarkRecordSize 256
+//bytes in each record of the recovery backlog, 10,000,000 records is ~10 GB
+#define kCWDurableQueueBenchmarkBacklogRecordSize 1024
+//every enqueue waits for a sync with CWQueueSyncPolicyEveryWrite, a full
+//-maxOperations run would mostly measure the disk
+#define kCWDurableQueueBenchmarkEveryWriteMaxOperations 20000
+
+static NSString *CWDurableQueueBenchmarkPolicyName(CWQueueSyncPolicy policy) {
+	switch (policy) {
+		case CWQueueSyncPolicyNone: return @"none";
+		case CWQueueSyncPolicyInterval: return @"interval";
+		case CWQueueSyncPolicyEveryWrite: return @"everyWrite";
+	}
+	return @"unknown";
+}
+
+static NSString *CWDurableQueueBenchmarkDirectory(NSString *root) {
+	return [root stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+}
+
+void CWRunDurableQueueBenchmarks(CWBenchmarkRunner *runner) {
+	NSString *root = [NSTemporaryDirectory() stringByAppendingPathComponent:
+					  [NSString stringWithFormat:@"CWDurableQueueBenchmarks-%d", getpid()]];
+	
+	NSMutableArray *payloads = [NSMutableArray array];
+	for (NSUInteger i = 0; i < 1024; i++) {
+		NSMutableData *payload = [NSMutableData dataWithLength:kCWDurableQueueBenchmarkRecordSize];
+		memset(payload.mutableBytes, (int)i, payload.length);
+		[payloads addObject:payload];
+	}
+	
+	NSMutableArray *threadCounts = [NSMutableArray arrayWithObject:@1];
+	if (runner.threads > 1) [threadCounts addObject:@(runner.threads)];
+	
+	//enqueue throughput at each sync policy, contended runs show group commit
+	for (NSNumber *policyNumber in @[ @(CWQueueSyncPolicyNone), @(CWQueueSyncPolicyInterval), @(CWQueueSyncPolicyEveryWrite) ]) {
+		CWQueueSyncPolicy policy = policyNumber.unsignedIntegerValue;
+		NSUInteger operations = runner.maxOperations;
+		if (policy == CWQueueSyncPolicyEveryWrite) operations = MIN(operations, (NSUInteger)kCWDurableQueueBenchmarkEveryWriteMaxOperations);
+		CWBenchmarkWorkload *workload = [[CWBenchmarkWorkload alloc] initWithPattern:CWBenchmarkPatternUniform
+																		  operations:operations
+																			keySpace:payloads.count];
+		NSString *name = [NSString stringWithFormat:@"CWQueue durable enqueue (%@)", CWDurableQueueBenchmarkPolicyName(policy)];
+		
+		for (NSNumber *threads in threadCounts) {
+			[runner runBenchmark:name
+						workload:workload
+							size:kCWDurableQueueBenchmarkRecordSize
+						 threads:threads.unsignedIntegerValue
+						   setup:^id{
+							   return [[CWQueue alloc] initWithDirectory:CWDurableQueueBenchmarkDirectory(root)
+															  syncPolicy:policy
+																   error:NULL];
+						   } operation:^(CWQueue *queue, CWBenchmarkOperation operation, uint32_t key) {
+							   //every operation is an enqueue, this measures the cost of durability
+							   [queue enqueue:payloads[key]];
+						   }];
+		}
+		[[NSFileManager defaultManager] removeItemAtPath:root error:NULL];
+	}
+	
+	//time to reopen a queue with a backlog of size records
+	NSMutableData *backlogPayload = [NSMutableData dataWithLength:kCWDurableQueueBenchmarkBacklogRecordSize];
+	for (NSNumber *sizeNumber in runner.sizes) {
+		NSUInteger size = sizeNumber.unsignedIntegerValue;
+		NSString *directory = CWDurableQueueBenchmarkDirectory(root);
+		__block id recovered = nil;
+		
+		[runner runBenchmark:@"CWQueue durable recovery" variant:@"backlog" size:size operations:size setup:^id{
+			@autoreleasepool {
+				CWQueue *queue = [[CWQueue alloc] initWithDirectory:directory syncPolicy:CWQueueSyncPolicyNone error:NULL];
+				for (NSUInteger i = 0; i < size; i++) {
+					@autoreleasepool {
+						[queue enqueue:backlogPayload];
+					}
+				}
+				[queue sync];
+			}
+			return nil;
+		} body:^NSDictionary *(id context) {
+			CWQueue *queue = [[CWQueue alloc] initWithDirectory:directory syncPolicy:CWQueueSyncPolicyNone error:NULL];
+			NSUInteger count = queue.count;
+			recovered = queue;
+			return @{ @"recoveredCount" : @(count),
+					  @"backlogBytes" : @((double)size * kCWDurableQueueBenchmarkBacklogRecordSize) };
+		}];
+		recovered = nil;
+		[[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+	}
+	[[NSFileManager defaultManager] removeItemAtPath:root error:NULL];
+}
@@ -0,0 +1,281 @@
+/*
+//  CWQueueBenchmarks.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWBenchmark.h"
+#import "CWQueue.h"
+#import "CWStack.h"
+#import "CWFixedQueue.h"
+#import "CWPriorityQueue.h"
+#import "CWInt64Queue.h"
+#import "CWPointerStack.h"
+#import "CWInt64PriorityQueue.h"
+
+//CWFixedQueue scans for duplicates on enqueue & CWPriorityQueue sorts its storage
+//on every insert, both are linear in their size so they run at smaller sizes
+#define kCWFixedQueueBenchmarkMaxSize 100000
+#define kCWPriorityQueueBenchmarkMaxSize 10000
+#define kCWPriorityQueueBenchmarkLevels 16
+
+static const CWBenchmarkPattern kCWQueueBenchmarkPatterns[] = {
+	CWBenchmarkPatternUniform, CWBenchmarkPatternZipf, CWBenchmarkPatternBurst
+};
+
+/**
+ Compares walking every object with for...in against the block enumeration
+ methods. Each variant is a tight loop that only counts the objects it visits
+ so the result is dominated by the cost of handing out objects.
+ */
+static void CWRunEnumerationBenchmarks(CWBenchmarkRunner *runner, NSArray *objects) {
+	NSUInteger size = objects.count;
+	
+	for (NSNumber *synchronized in @[ @YES, @NO ]) {
+		NSString *variant = synchronized.boolValue ? @"synchronized" : @"unsynchronized";
+		
+		id (^buildQueue)(void) = ^id{
+			CWQueue *queue = [[CWQueue alloc] initWithSynchronization:synchronized.boolValue];
+			[queue enqueueObjectsFromArray:objects];
+			return queue;
+		};
+		[runner runBenchmark:@"CWQueue for...in" variant:variant size:size operations:size setup:buildQueue body:^NSDictionary *(CWQueue *queue) {
+			NSUInteger visited = 0;
+			for (id object in queue) visited++;
+			return @{ @"visited" : @(visited) };
+		}];
+		[runner runBenchmark:@"CWQueue enumerateObjectsInQueue" variant:variant size:size operations:size setup:buildQueue body:^NSDictionary *(CWQueue *queue) {
+			__block NSUInteger visited = 0;
+			[queue enumerateObjectsInQueue:^(id object, BOOL *stop) {
+				visited++;
+			}];
+			return @{ @"visited" : @(visited) };
+		}];
+		
+		//CWStack has no block enumeration, compare against popping everything off
+		id (^buildStack)(void) = ^id{
+			CWStack *stack = [[CWStack alloc] initWithSynchronization:synchronized.boolValue];
+			for (id object in objects) [stack push:object];
+			return stack;
+		};
+		[runner runBenchmark:@"CWStack for...in" variant:variant size:size operations:size setup:buildStack body:^NSDictionary *(CWStack *stack) {
+			NSUInteger visited = 0;
+			for (id object in stack) visited++;
+			return @{ @"visited" : @(visited) };
+		}];
+		[runner runBenchmark:@"CWStack pop all" variant:variant size:size operations:size setup:buildStack body:^NSDictionary *(CWStack *stack) {
+			NSUInteger visited = 0;
+			while ([stack pop] != nil) visited++;
+			return @{ @"visited" : @(visited) };
+		}];
+	}
+	
+	id (^buildFixedQueue)(void) = ^id{
+		CWFixedQueue *queue = [[CWFixedQueue alloc] initWithCapacity:size];
+		[queue enqueueObjectsInArray:objects];
+		return queue;
+	};
+	[runner runBenchmark:@"CWFixedQueue for...in" variant:@"unsynchronized" size:size operations:size setup:buildFixedQueue body:^NSDictionary *(CWFixedQueue *queue) {
+		NSUInteger visited = 0;
+		for (id object in queue) visited++;
+		return @{ @"visited" : @(visited) };
+	}];
+	[runner runBenchmark:@"CWFixedQueue enumerateObjectsUsingBlock" variant:@"unsynchronized" size:size operations:size setup:buildFixedQueue body:^NSDictionary *(CWFixedQueue *queue) {
+		__block NSUInteger visited = 0;
+		[queue enumerateObjectsUsingBlock:^(id object, NSUInteger index, BOOL *stop) {
+			visited++;
+		}];
+		return @{ @"visited" : @(visited) };
+	}];
+}
+
+void CWRunQueueBenchmarks(CWBenchmarkRunner *runner) {
+	[runner runCreationBenchmark:@"CWQueue create" variant:@"synchronized" create:^id{
+		return [CWQueue new];
+	}];
+	[runner runCreationBenchmark:@"CWQueue create" variant:@"unsynchronized" create:^id{
+		return [[CWQueue alloc] initWithSynchronization:NO];
+	}];
+	[runner runCreationBenchmark:@"CWStack create" variant:@"synchronized" create:^id{
+		return [CWStack new];
+	}];
+	[runner runCreationBenchmark:@"CWStack create" variant:@"unsynchronized" create:^id{
+		return [[CWStack alloc] initWithSynchronization:NO];
+	}];
+	
+	for (NSNumber *sizeNumber in runner.sizes) {
+		NSUInteger size = sizeNumber.unsignedIntegerValue;
+		NSArray *keys = [runner numberKeysForKeySpace:size];
+		NSUInteger keyCount = keys.count;
+		
+		NSMutableArray *objects = [NSMutableArray arrayWithCapacity:size];
+		for (NSUInteger i = 0; i < size; i++) [objects addObject:keys[i % keyCount]];
+		CWRunEnumerationBenchmarks(runner, objects);
+		
+		for (size_t p = 0; p < sizeof(kCWQueueBenchmarkPatterns) / sizeof(kCWQueueBenchmarkPatterns[0]); p++) {
+			CWBenchmarkWorkload *workload = [[CWBenchmarkWorkload alloc] initWithPattern:kCWQueueBenchmarkPatterns[p]
+																			  operations:runner.maxOperations
+																				keySpace:keyCount];
+			
+			NSMutableArray *threadCounts = [NSMutableArray arrayWithObject:@1];
+			if (runner.threads > 1) [threadCounts addObject:@(runner.threads)];
+			
+			for (NSNumber *threads in threadCounts) {
+				[runner runBenchmark:@"CWQueue"
+							workload:workload
+								size:size
+							 threads:threads.unsignedIntegerValue
+							   setup:^id{
+								   CWQueue *queue = [CWQueue new];
+								   for (NSUInteger i = 0; i < size; i++) [queue enqueue:keys[i % keyCount]];
+								   return queue;
+							   } operation:^(CWQueue *queue, CWBenchmarkOperation operation, uint32_t key) {
+								   switch (operation) {
+									   case CWBenchmarkOperationInsert: [queue enqueue:keys[key]]; break;
+									   case CWBenchmarkOperationRemove: [queue dequeue]; break;
+									   case CWBenchmarkOperationLookup: [queue peek]; break;
+								   }
+							   }];
+				
+				[runner runBenchmark:@"CWStack"
+							workload:workload
+								size:size
+							 threads:threads.unsignedIntegerValue
+							   setup:^id{
+								   CWStack *stack = [CWStack new];
+								   for (NSUInteger i = 0; i < size; i++) [stack push:keys[i % keyCount]];
+								   return stack;
+							   } operation:^(CWStack *stack, CWBenchmarkOperation operation, uint32_t key) {
+								   switch (operation) {
+									   case CWBenchmarkOperationInsert: [stack push:keys[key]]; break;
+									   case CWBenchmarkOperationRemove: [stack pop]; break;
+									   case CWBenchmarkOperationLookup: [stack topOfStackObject]; break;
+								   }
+							   }];
+				
+				//the unboxed variants run the same workloads with the keys as values
+				[runner runBenchmark:@"CWInt64Queue"
+							workload:workload
+								size:size
+							 threads:threads.unsignedIntegerValue
+							   setup:^id{
+								   CWInt64Queue *queue = [CWInt64Queue new];
+								   for (NSUInteger i = 0; i < size; i++) [queue enqueueValue:(int64_t)(i % keyCount)];
+								   return queue;
+							   } operation:^(CWInt64Queue *queue, CWBenchmarkOperation operation, uint32_t key) {
+								   int64_t value;
+								   switch (operation) {
+									   case CWBenchmarkOperationInsert: [queue enqueueValue:key]; break;
+									   case CWBenchmarkOperationRemove: [queue dequeueValue:&value]; break;
+									   case CWBenchmarkOperationLookup: [queue peekValue:&value]; break;
+								   }
+							   }];
+				
+				//the pointers are never dereferenced, any non NULL value will do
+				[runner runBenchmark:@"CWPointerStack"
+							workload:workload
+								size:size
+							 threads:threads.unsignedIntegerValue
+							   setup:^id{
+								   CWPointerStack *stack = [CWPointerStack new];
+								   for (NSUInteger i = 0; i < size; i++) [stack pushPointer:(void *)(uintptr_t)((i % keyCount) + 1)];
+								   return stack;
+							   } operation:^(CWPointerStack *stack, CWBenchmarkOperation operation, uint32_t key) {
+								   switch (operation) {
+									   case CWBenchmarkOperationInsert: [stack pushPointer:(void *)(uintptr_t)(key + 1)]; break;
+									   case CWBenchmarkOperationRemove: [stack popPointer]; break;
+									   case CWBenchmarkOperationLookup: [stack topOfStackPointer]; break;
+								   }
+							   }];
+			}
+			
+			[runner runBenchmark:@"CWInt64PriorityQueue"
+						workload:workload
+							size:size
+						 threads:1
+						   setup:^id{
+							   CWInt64PriorityQueue *queue = [CWInt64PriorityQueue new];
+							   for (NSUInteger i = 0; i < size; i++) {
+								   [queue addValue:(int64_t)(i % keyCount) withPriority:i % kCWPriorityQueueBenchmarkLevels];
+							   }
+							   return queue;
+						   } operation:^(CWInt64PriorityQueue *queue, CWBenchmarkOperation operation, uint32_t key) {
+							   int64_t value;
+							   switch (operation) {
+								   case CWBenchmarkOperationInsert:
+									   [queue addValue:key withPriority:key % kCWPriorityQueueBenchmarkLevels];
+									   break;
+								   case CWBenchmarkOperationRemove: [queue dequeueValue:&value priority:NULL]; break;
+								   case CWBenchmarkOperationLookup: [queue peekValue:&value priority:NULL]; break;
+							   }
+						   }];
+			
+			//CWFixedQueue & CWPriorityQueue are not thread safe, single threaded only
+			if (size <= kCWFixedQueueBenchmarkMaxSize) {
+				[runner runBenchmark:@"CWFixedQueue"
+							workload:workload
+								size:size
+							 threads:1
+							   setup:^id{
+								   CWFixedQueue *queue = [[CWFixedQueue alloc] initWithCapacity:size];
+								   for (NSUInteger i = 0; i < size; i++) [queue enqueue:keys[i % keyCount]];
+								   return queue;
+							   } operation:^(CWFixedQueue *queue, CWBenchmarkOperation operation, uint32_t key) {
+								   switch (operation) {
+									   case CWBenchmarkOperationInsert: [queue enqueue:keys[key]]; break;
+									   case CWBenchmarkOperationRemove: [queue dequeue]; break;
+									   case CWBenchmarkOperationLookup: if (queue.count > 0) (void)queue[0]; break;
+								   }
+							   }];
+			}
+			
+			if (size <= kCWPriorityQueueBenchmarkMaxSize) {
+				[runner runBenchmark:@"CWPriorityQueue"
+							workload:workload
+								size:size
+							 threads:1
+							   setup:^id{
+								   CWPriorityQueue *queue = [CWPriorityQueue new];
+								   for (NSUInteger i = 0; i < size; i++) {
+									   [queue addItem:keys[i % keyCount] withPriority:i % kCWPriorityQueueBenchmarkLevels];
+								   }
+								   return queue;
+							   } operation:^(CWPriorityQueue *queue, CWBenchmarkOperation operation, uint32_t key) {
+								   switch (operation) {
+									   case CWBenchmarkOperationInsert:
+										   [queue addItem:keys[key] withPriority:key % kCWPriorityQueueBenchmarkLevels];
+										   break;
+									   case CWBenchmarkOperationRemove: [queue dequeue]; break;
+									   case CWBenchmarkOperationLookup: [queue peek]; break;
+								   }
+							   }];
+			}
+		}
+	}
+}
@@ -0,0 +1,319 @@
+/*
+//  CWTreeBenchmarks.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWBenchmark.h"
+#import "CWBenchmarkAllocations.h"
+#import "CWTree.h"
+#import "CWFlatTree.h"
+#include <math.h>
+
+//a CWTreeNode costs a few hundred bytes, past this a run is mostly page faults
+#define kCWTreeBenchmarkMaxSize 1000000
+//nodes release their children recursively, deep trees are capped & split
+//into chains so tearing them down stays well within the stack
+#define kCWTreeBenchmarkMaxDeepSize 100000
+#define kCWTreeBenchmarkChains 64
+//narrow trees are a few long chains, too narrow to split across every processor
+#define kCWTreeBenchmarkMaxNarrowSize 16000
+#define kCWTreeBenchmarkNarrowChains 4
+//containsObject: without the index is linear so only a few lookups are timed
+#define kCWTreeBenchmarkUnindexedLookups 100
+#define kCWTreeBenchmarkMaxQueries 100000
+//each removal scans the children so only this many are timed per wide node
+#define kCWTreeBenchmarkMaxRemovals 1000
+
+typedef NS_ENUM(NSUInteger, CWTreeBenchmarkShape) {
+	CWTreeBenchmarkShapeWide,
+	CWTreeBenchmarkShapeDeep,
+	CWTreeBenchmarkShapeNarrow
+};
+
+static NSString *CWTreeBenchmarkShapeName(CWTreeBenchmarkShape shape) {
+	switch (shape) {
+		case CWTreeBenchmarkShapeWide: return @"wide";
+		case CWTreeBenchmarkShapeDeep: return @"deep";
+		case CWTreeBenchmarkShapeNarrow: return @"narrow";
+	}
+	return nil;
+}
+
+static NSUInteger CWTreeBenchmarkChainCount(CWTreeBenchmarkShape shape) {
+	return (shape == CWTreeBenchmarkShapeNarrow) ? kCWTreeBenchmarkNarrowChains : kCWTreeBenchmarkChains;
+}
+
+/**
+ Builds a tree of count nodes with values[0..<count]
+ 
+ Wide trees have a root with √count children that each have √count children.
+ Deep trees have a root with kCWTreeBenchmarkChains long chains of nodes and
+ narrow trees one with kCWTreeBenchmarkNarrowChains even longer ones. If nodes
+ is not nil every node is added to it in the order it was created.
+ */
+static CWTree *CWTreeBenchmarkBuildTree(NSArray *values, NSUInteger count, CWTreeBenchmarkShape shape, NSMutableArray *nodes) {
+	CWTree *tree = [[CWTree alloc] initWithRootNodeValue:values[0]];
+	[nodes addObject:tree.rootNode];
+	if (shape == CWTreeBenchmarkShapeWide) {
+		NSUInteger fanout = MAX((NSUInteger)1, (NSUInteger)ceil(sqrt((double)count)));
+		NSUInteger i = 1;
+		while (i < count) {
+			CWTreeNode *child = [[CWTreeNode alloc] initWithValue:values[i++]];
+			[tree.rootNode addChild:child];
+			[nodes addObject:child];
+			for (NSUInteger j = 1; j < fanout && i < count; j++) {
+				CWTreeNode *grandchild = [[CWTreeNode alloc] initWithValue:values[i++]];
+				[child addChild:grandchild];
+				[nodes addObject:grandchild];
+			}
+		}
+	} else {
+		NSUInteger chains = CWTreeBenchmarkChainCount(shape);
+		NSMutableArray *tails = [NSMutableArray arrayWithCapacity:chains];
+		for (NSUInteger i = 0; i < chains; i++) [tails addObject:tree.rootNode];
+		for (NSUInteger i = 1; i < count; i++) {
+			CWTreeNode *node = [[CWTreeNode alloc] initWithValue:values[i]];
+			NSUInteger chain = i % chains;
+			[(CWTreeNode *)tails[chain] addChild:node];
+			tails[chain] = node;
+			[nodes addObject:node];
+		}
+	}
+	return tree;
+}
+
+static CWFlatTree *CWTreeBenchmarkBuildFlatTree(NSArray *values, NSUInteger count, CWTreeBenchmarkShape shape) {
+	CWFlatTree *tree = [[CWFlatTree alloc] initWithRootValue:values[0]];
+	[tree reserveCapacity:count];
+	CWFlatTreeNodeID root = tree.rootNode;
+	if (shape == CWTreeBenchmarkShapeWide) {
+		NSUInteger fanout = MAX((NSUInteger)1, (NSUInteger)ceil(sqrt((double)count)));
+		NSUInteger i = 1;
+		while (i < count) {
+			CWFlatTreeNodeID child = [tree addChildWithValue:values[i++] toNode:root];
+			for (NSUInteger j = 1; j < fanout && i < count; j++) {
+				[tree addChildWithValue:values[i++] toNode:child];
+			}
+		}
+	} else {
+		NSUInteger chains = CWTreeBenchmarkChainCount(shape);
+		CWFlatTreeNodeID tails[kCWTreeBenchmarkChains];
+		for (NSUInteger i = 0; i < chains; i++) tails[i] = root;
+		for (NSUInteger i = 1; i < count; i++) {
+			NSUInteger chain = i % chains;
+			tails[chain] = [tree addChildWithValue:values[i] toNode:tails[chain]];
+		}
+	}
+	return tree;
+}
+
+static void CWRunTreeShapeBenchmarks(CWBenchmarkRunner *runner, NSUInteger size, CWTreeBenchmarkShape shape) {
+	NSArray *values = [runner numberKeysForKeySpace:size + 1];
+	NSString *variant = CWTreeBenchmarkShapeName(shape);
+	
+	//built structures are kept alive until after timing so teardown isn't measured
+	__block id built = nil;
+	
+	[runner runBenchmark:@"CWTree build" variant:variant size:size operations:size setup:nil body:^NSDictionary *(id context) {
+		int64_t bytesBefore = CWBenchmarkThreadLiveBytes();
+		CWTree *tree = CWTreeBenchmarkBuildTree(values, size, shape, nil);
+		int64_t bytes = CWBenchmarkThreadLiveBytes() - bytesBefore;
+		built = tree;
+		if (!CWBenchmarkAllocationCountingAvailable()) return nil;
+		return @{ @"bytesPerNode" : @((double)bytes / (double)size) };
+	}];
+	built = nil;
+	
+	[runner runBenchmark:@"CWFlatTree build" variant:variant size:size operations:size setup:nil body:^NSDictionary *(id context) {
+		int64_t bytesBefore = CWBenchmarkThreadLiveBytes();
+		CWFlatTree *tree = CWTreeBenchmarkBuildFlatTree(values, size, shape);
+		int64_t bytes = CWBenchmarkThreadLiveBytes() - bytesBefore;
+		NSUInteger storageSize = tree.storageSize;
+		built = tree;
+		if (!CWBenchmarkAllocationCountingAvailable()) return @{ @"storageBytesPerNode" : @((double)storageSize / (double)size) };
+		return @{ @"bytesPerNode" : @((double)bytes / (double)size),
+				  @"storageBytesPerNode" : @((double)storageSize / (double)size) };
+	}];
+	built = nil;
+	
+	id (^buildTree)(void) = ^id{
+		return CWTreeBenchmarkBuildTree(values, size, shape, nil);
+	};
+	
+	[runner runBenchmark:@"CWTree enumerate" variant:variant size:size operations:size setup:buildTree body:^NSDictionary *(CWTree *tree) {
+		__block NSUInteger visited = 0;
+		[tree enumerateTreeWithBlock:^(id nodeValue, id node, BOOL *stop) {
+			visited++;
+		}];
+		return @{ @"visited" : @(visited) };
+	}];
+	
+	//a grain size no tree can reach makes the concurrent methods run serially,
+	//which gives a 1 thread baseline to compare running on every processor with
+	NSUInteger processors = [[NSProcessInfo processInfo] activeProcessorCount];
+	for (NSNumber *threads in @[ @1, @(processors) ]) {
+		BOOL serial = (threads.unsignedIntegerValue == 1);
+		id (^buildConcurrentTree)(void) = ^id{
+			CWTree *tree = buildTree();
+			if (serial) tree.concurrentGrainSize = NSUIntegerMax;
+			return tree;
+		};
+		
+		[runner runBenchmark:@"CWTree concurrentEnumerate" variant:variant size:size operations:size setup:buildConcurrentTree body:^NSDictionary *(CWTree *tree) {
+			__block int64_t visited = 0;
+			[tree concurrentEnumerateTreeWithBlock:^(id nodeValue, id node, BOOL *stop) {
+				__atomic_add_fetch(&visited, 1, __ATOMIC_RELAXED);
+			}];
+			return @{ @"visited" : @(visited), @"threads" : threads };
+		}];
+		
+		[runner runBenchmark:@"CWTree reduceSubtrees" variant:variant size:size operations:size setup:buildConcurrentTree body:^NSDictionary *(CWTree *tree) {
+			NSNumber *total = [tree reduceSubtreesWithBlock:^id(id nodeValue, CWTreeNode *node, NSArray *childResults) {
+				NSUInteger sum = 1;
+				for (NSNumber *result in childResults) sum += result.unsignedIntegerValue;
+				return @(sum);
+			}];
+			return @{ @"visited" : total, @"threads" : threads };
+		}];
+		if (processors == 1) break;
+	}
+	
+	[runner runBenchmark:@"CWFlatTree enumerate" variant:variant size:size operations:size setup:^id{
+		return CWTreeBenchmarkBuildFlatTree(values, size, shape);
+	} body:^NSDictionary *(CWFlatTree *tree) {
+		__block NSUInteger visited = 0;
+		[tree enumerateTreeWithBlock:^(id nodeValue, CWFlatTreeNodeID node, BOOL *stop) {
+			visited++;
+		}];
+		return @{ @"visited" : @(visited) };
+	}];
+	
+	//look up values spread across the tree & half as many values it doesn't hold
+	NSUInteger indexedLookups = MIN(runner.maxOperations, (NSUInteger)kCWTreeBenchmarkMaxQueries);
+	NSUInteger unindexedLookups = MIN(indexedLookups, (NSUInteger)kCWTreeBenchmarkUnindexedLookups);
+	NSArray *missingValues = @[ @(-1), @(-2), @(-3) ];
+	NSDictionary *(^lookup)(CWTree *, NSUInteger) = ^NSDictionary *(CWTree *tree, NSUInteger lookups) {
+		NSUInteger found = 0;
+		for (NSUInteger i = 0; i < lookups; i++) {
+			id value = (i % 3 == 2) ? missingValues[i % missingValues.count] : values[(i * 7919) % size];
+			if ([tree containsObject:value]) found++;
+		}
+		return @{ @"found" : @(found) };
+	};
+	
+	[runner runBenchmark:@"CWTree containsObject" variant:[variant stringByAppendingString:@"-unindexed"] size:size operations:unindexedLookups setup:buildTree body:^NSDictionary *(CWTree *tree) {
+		return lookup(tree, unindexedLookups);
+	}];
+	
+	[runner runBenchmark:@"CWTree containsObject" variant:[variant stringByAppendingString:@"-indexed"] size:size operations:indexedLookups setup:^id{
+		CWTree *tree = buildTree();
+		tree.indexesNodeValues = YES;
+		return tree;
+	} body:^NSDictionary *(CWTree *tree) {
+		return lookup(tree, indexedLookups);
+	}];
+	
+	[runner runBenchmark:@"CWTree diffWithTree" variant:variant size:size operations:size setup:^id{
+		CWTree *tree = buildTree();
+		NSMutableArray *nodes = [NSMutableArray arrayWithCapacity:size];
+		CWTree *other = CWTreeBenchmarkBuildTree(values, size, shape, nodes);
+		//hash both trees up front, a diff after one small edit is the case to measure
+		[tree.rootNode subtreeHash];
+		[other.rootNode subtreeHash];
+		((CWTreeNode *)nodes[size / 2]).value = @(-1);
+		return @[ tree, other ];
+	} body:^NSDictionary *(NSArray *trees) {
+		CWTreeDiff *diff = [trees[0] diffWithTree:trees[1]];
+		return @{ @"changedNodes" : @(diff.changedNodes.count) };
+	}];
+	
+	if (shape == CWTreeBenchmarkShapeDeep) {
+		NSUInteger queries = MIN(runner.maxOperations, (NSUInteger)kCWTreeBenchmarkMaxQueries);
+		CWBenchmarkWorkload *pairs = [[CWBenchmarkWorkload alloc] initWithPattern:CWBenchmarkPatternUniform
+																	   operations:queries * 2
+																		 keySpace:size];
+		[runner runBenchmark:@"CWTreeNode lowestCommonAncestorWith" variant:variant size:size operations:queries setup:^id{
+			NSMutableArray *nodes = [NSMutableArray arrayWithCapacity:size];
+			CWTree *tree = CWTreeBenchmarkBuildTree(values, size, shape, nodes);
+			return @[ tree, nodes ];
+		} body:^NSDictionary *(NSArray *context) {
+			NSArray *nodes = context[1];
+			const uint32_t *keys = pairs.keys;
+			NSUInteger ancestors = 0;
+			for (NSUInteger i = 0; i < queries; i++) {
+				CWTreeNode *a = nodes[keys[i * 2]];
+				CWTreeNode *b = nodes[keys[(i * 2) + 1]];
+				CWTreeNode *common = [a lowestCommonAncestorWith:b];
+				if ([common isAncestorOf:a]) ancestors++;
+			}
+			return @{ @"ancestors" : @(ancestors) };
+		}];
+	} else if (shape == CWTreeBenchmarkShapeWide) {
+		[runner runBenchmark:@"CWTreeNode addChild" variant:variant size:size operations:size setup:nil body:^NSDictionary *(id context) {
+			CWTreeNode *parent = [[CWTreeNode alloc] initWithValue:values[0]];
+			for (NSUInteger i = 1; i <= size; i++) {
+				[parent addChild:[[CWTreeNode alloc] initWithValue:values[i]]];
+			}
+			built = parent;
+			return @{ @"children" : @(parent.children.count) };
+		}];
+		built = nil;
+		
+		NSUInteger removals = MIN(size, (NSUInteger)kCWTreeBenchmarkMaxRemovals);
+		[runner runBenchmark:@"CWTreeNode removeChild" variant:variant size:size operations:removals setup:^id{
+			CWTreeNode *parent = [[CWTreeNode alloc] initWithValue:values[0]];
+			for (NSUInteger i = 1; i <= size; i++) {
+				[parent addChild:[[CWTreeNode alloc] initWithValue:values[i]]];
+			}
+			//children spread across the node so removals don't favour either end
+			NSMutableArray *victims = [NSMutableArray arrayWithCapacity:removals];
+			for (NSUInteger i = 0; i < removals; i++) {
+				[victims addObject:parent.children[(i * 7919) % size]];
+			}
+			return @[ parent, victims ];
+		} body:^NSDictionary *(NSArray *context) {
+			CWTreeNode *parent = context[0];
+			for (CWTreeNode *child in context[1]) [parent removeChild:child];
+			return @{ @"children" : @(parent.children.count) };
+		}];
+	}
+}
+
+void CWRunTreeBenchmarks(CWBenchmarkRunner *runner) {
+	for (NSNumber *size in [runner sizesUpTo:kCWTreeBenchmarkMaxSize]) {
+		CWRunTreeShapeBenchmarks(runner, size.unsignedIntegerValue, CWTreeBenchmarkShapeWide);
+	}
+	for (NSNumber *size in [runner sizesUpTo:kCWTreeBenchmarkMaxDeepSize]) {
+		CWRunTreeShapeBenchmarks(runner, size.unsignedIntegerValue, CWTreeBenchmarkShapeDeep);
+	}
+	for (NSNumber *size in [runner sizesUpTo:kCWTreeBenchmarkMaxNarrowSize]) {
+		CWRunTreeShapeBenchmarks(runner, size.unsignedIntegerValue, CWTreeBenchmarkShapeNarrow);
+	}
+}
@@ -0,0 +1,88 @@
+/*
+//  CWTrieBenchmarks.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWBenchmark.h"
+#import "CWTrie.h"
+
+//every key allocates a node per character, past this the benchmark measures
+//the allocator more than the trie
+#define kCWTrieBenchmarkMaxSize 1000000
+
+static const CWBenchmarkPattern kCWTrieBenchmarkPatterns[] = {
+	CWBenchmarkPatternUniform, CWBenchmarkPatternZipf, CWBenchmarkPatternBurst
+};
+
+void CWRunTrieBenchmarks(CWBenchmarkRunner *runner) {
+	[runner runCreationBenchmark:@"CWTrie create" variant:@"synchronized" create:^id{
+		return [CWTrie new];
+	}];
+	[runner runCreationBenchmark:@"CWTrie create" variant:@"unsynchronized" create:^id{
+		return [[CWTrie alloc] initWithCaseSensitiveKeys:NO synchronized:NO];
+	}];
+	
+	for (NSNumber *sizeNumber in [runner sizesUpTo:kCWTrieBenchmarkMaxSize]) {
+		NSUInteger size = sizeNumber.unsignedIntegerValue;
+		NSArray *keys = [runner stringKeysForKeySpace:size];
+		NSUInteger keyCount = keys.count;
+		
+		for (size_t p = 0; p < sizeof(kCWTrieBenchmarkPatterns) / sizeof(kCWTrieBenchmarkPatterns[0]); p++) {
+			CWBenchmarkWorkload *workload = [[CWBenchmarkWorkload alloc] initWithPattern:kCWTrieBenchmarkPatterns[p]
+																			  operations:runner.maxOperations
+																				keySpace:keyCount];
+			
+			NSMutableArray *threadCounts = [NSMutableArray arrayWithObject:@1];
+			if (runner.threads > 1) [threadCounts addObject:@(runner.threads)];
+			
+			for (NSNumber *threads in threadCounts) {
+				[runner runBenchmark:@"CWTrie"
+							workload:workload
+								size:size
+							 threads:threads.unsignedIntegerValue
+							   setup:^id{
+								   CWTrie *trie = [CWTrie new];
+								   //fill every other key so removes & lookups hit & miss
+								   for (NSUInteger i = 0; i < keyCount; i += 2) {
+									   [trie setObjectValue:keys[i] forKey:keys[i]];
+								   }
+								   return trie;
+							   } operation:^(CWTrie *trie, CWBenchmarkOperation operation, uint32_t key) {
+								   NSString *keyString = keys[key];
+								   switch (operation) {
+									   case CWBenchmarkOperationInsert: [trie setObjectValue:keyString forKey:keyString]; break;
+									   case CWBenchmarkOperationRemove: [trie removeObjectValueForKey:keyString]; break;
+									   case CWBenchmarkOperationLookup: [trie objectValueForKey:keyString]; break;
+								   }
+							   }];
+			}
+		}
+	}
+}
@@ -0,0 +1,210 @@
+/*
+//  CWWorkStealingDequeBenchmarks.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWBenchmark.h"
+#import "CWWorkStealingDeque.h"
+#import "CWStack.h"
+#include <pthread.h>
+#include <sched.h>
+
+//ranges at or below this many values are summed instead of split
+#define kCWForkJoinBenchmarkGrain 1024
+
+typedef NS_ENUM(NSUInteger, CWForkJoinScheduler) {
+	CWForkJoinSchedulerWorkStealing,
+	CWForkJoinSchedulerSharedStack
+};
+
+/**
+ A fork-join tree sum over an array of values. Each task is a range of the
+ array held in a NSValue. A worker splits its range in half until it is no
+ bigger than the grain, pushing the upper halves for later & summing the last
+ piece itself, which builds the same task tree a recursive parallel sum does.
+ 
+ With CWForkJoinSchedulerWorkStealing every worker has a CWWorkStealingDeque,
+ pops its own tasks & steals from the other workers when it runs out. With
+ CWForkJoinSchedulerSharedStack every worker pushes & pops on one synchronized
+ CWStack, which is the baseline the deque is meant to beat.
+ */
+@interface CWForkJoinBenchmarkPool : NSObject {
+@public
+	const uint32_t *_values;
+	uint64_t _remaining;
+	uint64_t _sum;
+	uint64_t _steals;
+	volatile int _go;
+}
+@property(strong) NSArray *deques;
+@property(strong) CWStack *sharedStack;
+@property(assign) CWForkJoinScheduler scheduler;
+@property(assign) NSUInteger workers;
+@end
+
+@implementation CWForkJoinBenchmarkPool
+
+-(void)pushTask:(NSValue *)task worker:(NSUInteger)worker {
+	if (self.scheduler == CWForkJoinSchedulerWorkStealing) {
+		[(CWWorkStealingDeque *)self.deques[worker] pushObject:task];
+	} else {
+		[self.sharedStack push:task];
+	}
+}
+
+-(NSValue *)takeTaskForWorker:(NSUInteger)worker {
+	if (self.scheduler == CWForkJoinSchedulerSharedStack) return [self.sharedStack pop];
+	
+	NSValue *task = [(CWWorkStealingDeque *)self.deques[worker] popObject];
+	if (task) return task;
+	for (NSUInteger offset = 1; offset < self.workers; offset++) {
+		task = [(CWWorkStealingDeque *)self.deques[(worker + offset) % self.workers] stealObject];
+		if (task) {
+			__atomic_fetch_add(&_steals, 1, __ATOMIC_RELAXED);
+			return task;
+		}
+	}
+	return nil;
+}
+
+-(void)runWorker:(NSUInteger)worker {
+	while (!__atomic_load_n(&_go, __ATOMIC_ACQUIRE)) { }
+	
+	uint64_t sum = 0;
+	while (__atomic_load_n(&_remaining, __ATOMIC_ACQUIRE) > 0) {
+		@autoreleasepool {
+			NSValue *task = [self takeTaskForWorker:worker];
+			if (task == nil) {
+				sched_yield();
+				continue;
+			}
+			
+			NSRange range = task.rangeValue;
+			while (range.length > kCWForkJoinBenchmarkGrain) {
+				NSUInteger half = range.length / 2;
+				[self pushTask:[NSValue valueWithRange:NSMakeRange(range.location + half, range.length - half)] worker:worker];
+				range.length = half;
+			}
+			
+			uint64_t rangeSum = 0;
+			for (NSUInteger i = range.location; i < NSMaxRange(range); i++) rangeSum += _values[i];
+			sum += rangeSum;
+			__atomic_fetch_sub(&_remaining, range.length, __ATOMIC_RELEASE);
+		}
+	}
+	__atomic_fetch_add(&_sum, sum, __ATOMIC_RELAXED);
+}
+
+@end
+
+@interface CWForkJoinBenchmarkWorker : NSObject
+@property(strong) CWForkJoinBenchmarkPool *pool;
+@property(assign) NSUInteger index;
+@end
+
+@implementation CWForkJoinBenchmarkWorker
+@end
+
+static void *CWForkJoinBenchmarkThreadMain(void *argument) {
+	@autoreleasepool {
+		CWForkJoinBenchmarkWorker *worker = (__bridge CWForkJoinBenchmarkWorker *)argument;
+		[worker.pool runWorker:worker.index];
+	}
+	return NULL;
+}
+
+/**
+ Sums values with workers threads, returning the sum & number of steals
+ */
+static uint64_t CWForkJoinBenchmarkSum(const uint32_t *values, NSUInteger count, NSUInteger workers,
+									   CWForkJoinScheduler scheduler, uint64_t *steals) {
+	CWForkJoinBenchmarkPool *pool = [CWForkJoinBenchmarkPool new];
+	pool->_values = values;
+	pool->_remaining = count;
+	pool->_sum = 0;
+	pool->_steals = 0;
+	pool->_go = 0;
+	pool.scheduler = scheduler;
+	pool.workers = workers;
+	if (scheduler == CWForkJoinSchedulerWorkStealing) {
+		NSMutableArray *deques = [NSMutableArray array];
+		for (NSUInteger w = 0; w < workers; w++) [deques addObject:[CWWorkStealingDeque new]];
+		pool.deques = deques;
+	} else {
+		pool.sharedStack = [CWStack new];
+	}
+	[pool pushTask:[NSValue valueWithRange:NSMakeRange(0, count)] worker:0];
+	
+	NSMutableArray *threadWorkers = [NSMutableArray array];
+	pthread_t *handles = malloc(workers * sizeof(pthread_t));
+	for (NSUInteger w = 0; w < workers; w++) {
+		CWForkJoinBenchmarkWorker *worker = [CWForkJoinBenchmarkWorker new];
+		worker.pool = pool;
+		worker.index = w;
+		[threadWorkers addObject:worker];
+		pthread_create(&handles[w], NULL, CWForkJoinBenchmarkThreadMain, (__bridge void *)worker);
+	}
+	__atomic_store_n(&pool->_go, 1, __ATOMIC_RELEASE);
+	for (NSUInteger w = 0; w < workers; w++) pthread_join(handles[w], NULL);
+	free(handles);
+	
+	if (steals) *steals = pool->_steals;
+	return pool->_sum;
+}
+
+void CWRunWorkStealingDequeBenchmarks(CWBenchmarkRunner *runner) {
+	NSMutableArray *workerCounts = [NSMutableArray array];
+	for (NSUInteger workers = 1; workers < runner.threads; workers *= 2) [workerCounts addObject:@(workers)];
+	[workerCounts addObject:@(MAX(runner.threads, (NSUInteger)1))];
+	
+	for (NSNumber *sizeNumber in runner.sizes) {
+		NSUInteger size = sizeNumber.unsignedIntegerValue;
+		uint32_t *values = malloc(MAX(size, (NSUInteger)1) * sizeof(uint32_t));
+		uint64_t expected = 0;
+		for (NSUInteger i = 0; i < size; i++) {
+			values[i] = (uint32_t)((i * 2654435761u) >> 16);
+			expected += values[i];
+		}
+		
+		for (NSNumber *workers in workerCounts) {
+			for (NSNumber *scheduler in @[ @(CWForkJoinSchedulerWorkStealing), @(CWForkJoinSchedulerSharedStack) ]) {
+				NSString *variant = (scheduler.unsignedIntegerValue == CWForkJoinSchedulerWorkStealing) ? @"workStealing" : @"sharedStack";
+				[runner runBenchmark:@"fork-join tree sum" variant:variant size:size operations:size setup:nil body:^NSDictionary *(id context) {
+					uint64_t steals = 0;
+					uint64_t sum = CWForkJoinBenchmarkSum(values, size, workers.unsignedIntegerValue,
+														  scheduler.unsignedIntegerValue, &steals);
+					CWAssert(sum == expected);
+					return @{ @"threads" : workers, @"steals" : @(steals) };
+				}];
+			}
+		}
+		free(values);
+	}
+}
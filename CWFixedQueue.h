@@ -38,6 +38,7 @@
   */
 
 #import <Foundation/Foundation.h>
+#import "CWStatistics.h"
 
 /**
  CWFixedQueue
@@ -53,7 +54,7 @@
 
 typedef void (^CWFixedQueueEvictionBlock)(id evictedObject);
 
-@interface CWFixedQueue : NSObject
+@interface CWFixedQueue : NSObject <NSFastEnumeration>
 
 /**
  Initializes the Queue & sets the capacity property to the NSUInteger passed in
@@ -172,4 +173,33 @@ typedef void (^CWFixedQueueEvictionBlock)(id evictedObject);
 -(void)enumerateObjectsWithOptions:(NSEnumerationOptions)options
 						usingBlock:(void (^)(id object, NSUInteger index, BOOL *stop))block;
 
+/**
+ Fast enumeration over the queue, lets you use for...in on a CWFixedQueue
+ 
+ Objects are given out from index 0 up, straight from the queues storage.
+ Enqueueing, dequeueing or setting an object during the loop raises an
+ exception just like mutating a NSMutableArray during a for...in would.
+ */
+-(NSUInteger)countByEnumeratingWithState:(NSFastEnumerationState *)state
+								 objects:(id __unsafe_unretained [])buffer
+								   count:(NSUInteger)len;
+
+#if CW_STATISTICS
+
+/**
+ Returns the statistics the queue has kept since it was created
+ 
+ The dictionary contains enqueueCount, requeueCount (enqueues of an object
+ already in the queue, which moves it to the back), dequeueCount,
+ emptyDequeueCount (calls to -dequeue on an empty queue), evictionCount (objects
+ pushed out for going over capacity) & highWaterCount (the most objects the
+ queue has held at once, which can briefly exceed capacity before evicting).
+ Only available when CW_STATISTICS is set to 1.
+ 
+ @return a NSDictionary with the queue's statistics
+ */
+-(NSDictionary *)statistics;
+
+#endif
+
 @end
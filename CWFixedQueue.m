@@ -35,7 +35,22 @@
 
 #define kCWFixedQueueDefaultCapacity 50
 
-@interface CWFixedQueue()
+#if CW_STATISTICS
+typedef struct CWFixedQueueStatistics {
+	uint64_t enqueueCount;
+	uint64_t requeueCount;
+	uint64_t dequeueCount;
+	uint64_t emptyDequeueCount;
+	uint64_t evictionCount;
+	uint64_t highWaterCount;
+} CWFixedQueueStatistics;
+#endif
+
+@interface CWFixedQueue() {
+#if CW_STATISTICS
+	CWFixedQueueStatistics _statistics;
+#endif
+}
 @property(strong) NSMutableArray *storage;
 @end
 
@@ -96,10 +111,13 @@
 
 -(void)enqueue:(id)object {
 	if(object == nil) return;
+	CWStatisticsCount(_statistics.enqueueCount);
 	if (![self.storage containsObject:object]) {
 		[self.storage addObject:object];
+		CWStatisticsHighWater(_statistics.highWaterCount, self.storage.count);
 		[self clearExcessObjects];
 	} else {
+		CWStatisticsCount(_statistics.requeueCount);
 		NSUInteger objectIndex = [self.storage indexOfObject:object];
 		[self.storage removeObjectAtIndex:objectIndex];
 		[self.storage addObject:object];
@@ -110,6 +128,8 @@
 	CWAssert(array != nil);
 	if(array.count == 0) return;
 	[self.storage addObjectsFromArray:array];
+	CWStatisticsAdd(_statistics.enqueueCount, array.count);
+	CWStatisticsHighWater(_statistics.highWaterCount, self.storage.count);
 	[self clearExcessObjects];
 }
 
@@ -117,11 +137,16 @@
 	while (self.storage.count > self.capacity) {
 		if (self.evictionBlock) self.evictionBlock(self.storage[0]);
 		[self.storage removeObjectAtIndex:0];
+		CWStatisticsCount(_statistics.evictionCount);
 	}
 }
 
 -(id)dequeue {
-	if(self.storage.count == 0) return nil;
+	if(self.storage.count == 0) {
+		CWStatisticsCount(_statistics.emptyDequeueCount);
+		return nil;
+	}
+	CWStatisticsCount(_statistics.dequeueCount);
 	id dequeuedObject = self.storage[0];
 	[self.storage removeObjectAtIndex:0];
 	return dequeuedObject;
@@ -141,4 +166,25 @@
 								   usingBlock:block];
 }
 
+-(NSUInteger)countByEnumeratingWithState:(NSFastEnumerationState *)state
+								 objects:(id __unsafe_unretained [])buffer
+								   count:(NSUInteger)len {
+	return [self.storage countByEnumeratingWithState:state objects:buffer count:len];
+}
+
+#if CW_STATISTICS
+
+#pragma mark Statistics -
+
+-(NSDictionary *)statistics {
+	return @{ @"enqueueCount" : @(CWStatisticsLoad(&_statistics.enqueueCount)),
+			  @"requeueCount" : @(CWStatisticsLoad(&_statistics.requeueCount)),
+			  @"dequeueCount" : @(CWStatisticsLoad(&_statistics.dequeueCount)),
+			  @"emptyDequeueCount" : @(CWStatisticsLoad(&_statistics.emptyDequeueCount)),
+			  @"evictionCount" : @(CWStatisticsLoad(&_statistics.evictionCount)),
+			  @"highWaterCount" : @(CWStatisticsLoad(&_statistics.highWaterCount)) };
+}
+
+#endif
+
 @end
@@ -168,6 +168,52 @@ describe(@"enumeration operations", ^{
 			++count;
 		}];
 	});
+	
+	it(@"should enumerate contents in order with for...in", ^{
+		NSMutableArray *results = [NSMutableArray array];
+		for (id object in queue) {
+			[results addObject:object];
+		}
+		
+		expect(results).to.equal(@[ @"Everybody Watch",@"Hypnotoad" ]);
+	});
+	
+	it(@"should raise when mutated during for...in", ^{
+		CWFixedQueue *mutatedQueue = [CWFixedQueue new];
+		mutatedQueue.capacity = 5;
+		[mutatedQueue enqueueObjectsInArray:@[ @"Fry",@"Leela" ]];
+		
+		expect(^{
+			for (id object in mutatedQueue) {
+				[mutatedQueue dequeue];
+			}
+		}).to.raiseAny();
+	});
 });
 
+#if CW_STATISTICS
+
+describe(@"-statistics", ^{
+	it(@"should count evictions & requeued objects", ^{
+		CWFixedQueue *queue = [[CWFixedQueue alloc] initWithCapacity:2];
+		[queue enqueue:@"Fry"];
+		[queue enqueue:@"Leela"];
+		[queue enqueue:@"Fry"];
+		[queue enqueue:@"Bender"];
+		[queue dequeue];
+		[queue dequeue];
+		[queue dequeue];
+		
+		NSDictionary *statistics = queue.statistics;
+		expect(statistics[@"enqueueCount"]).to.equal(@4);
+		expect(statistics[@"requeueCount"]).to.equal(@1);
+		expect(statistics[@"evictionCount"]).to.equal(@1);
+		expect(statistics[@"dequeueCount"]).to.equal(@2);
+		expect(statistics[@"emptyDequeueCount"]).to.equal(@1);
+		expect(statistics[@"highWaterCount"]).to.equal(@3);
+	});
+});
+
+#endif
+
 SpecEnd
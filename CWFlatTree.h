@@ -0,0 +1,201 @@
+/*
+//  CWFlatTree.h
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+ /*
+ This class should not make any use of the Zangetsu Framework API's so it can
+ retain its independence and be used in other projects not making use of the
+ Zangetsu Framework.
+  */
+
+#import <Foundation/Foundation.h>
+
+@class CWTree;
+
+/**
+ Identifies a node in a CWFlatTree. Node ID's are indexes into the trees node
+ storage, the root node is always 0 and nodes are numbered in the order they
+ were added to the tree.
+ */
+typedef NSUInteger CWFlatTreeNodeID;
+
+/**
+ Returned when there is no node, i.e. asking for the parent of the root node
+ */
+#define kCWFlatTreeNoNode NSNotFound
+
+/**
+ CWFlatTree
+
+ CWFlatTree is a compact tree for very large trees. Instead of an object per
+ node it stores every node as a small fixed size record (parent, first child,
+ last child, next sibling, child count & level) in one contiguous block of
+ memory, with the node values in a second contiguous block, and refers to nodes
+ by integer ID. This costs 32 bytes per node on 64 bit systems, plus whatever
+ spare capacity the storage has grown into, gives good cache locality when
+ walking the tree & makes -levelOfNode: a constant time lookup.
+ 
+ Nodes can be added, but not removed. CWFlatTree can be built from an existing
+ CWTree and converted back into one. Like CWTree it is not thread safe.
+ */
+
+@interface CWFlatTree : NSObject
+
+/**
+ Initializes & returns a new CWFlatTree with a root node holding value
+ 
+ @param value the value for the root node, may be nil
+ @return an initialized CWFlatTree instance
+ */
+-(instancetype)initWithRootValue:(id)value;
+
+/**
+ Initializes & returns a new CWFlatTree with the same shape & values as tree
+ 
+ Nodes are copied level by level so siblings are stored next to each other. If
+ tree has no root node the returned tree has no nodes.
+ 
+ @param tree the CWTree to copy
+ @return an initialized CWFlatTree instance
+ */
+-(instancetype)initWithTree:(CWTree *)tree;
+
+/**
+ Returns a new CWTree with the same shape & values as the receiver
+ 
+ Every node in the returned tree allows duplicates so that siblings sharing a
+ value in the receiver are all carried over.
+ 
+ @return a new CWTree, which has no root node if the receiver has no nodes
+ */
+-(CWTree *)tree;
+
+/**
+ The number of nodes in the receiver
+ */
+@property(readonly) NSUInteger count;
+
+/**
+ The number of bytes the receivers node & value storage occupies
+ 
+ This includes spare capacity but not the node values themselves.
+ */
+@property(readonly) NSUInteger storageSize;
+
+/**
+ Grows the receivers storage so it can hold capacity nodes without reallocating
+ 
+ @param capacity the total number of nodes the receiver should have room for
+ */
+-(void)reserveCapacity:(NSUInteger)capacity;
+
+/**
+ Returns the root nodes ID or kCWFlatTreeNoNode if the receiver has no nodes
+ */
+-(CWFlatTreeNodeID)rootNode;
+
+/**
+ Adds a new node holding value as the last child of parent
+ 
+ @param value the value for the new node, may be nil
+ @param parent the ID of an existing node. An assertion is thrown if invalid.
+ @return the ID of the new node
+ */
+-(CWFlatTreeNodeID)addChildWithValue:(id)value toNode:(CWFlatTreeNodeID)parent;
+
+/**
+ Returns the value of node
+ 
+ @param node the ID of an existing node. An assertion is thrown if invalid.
+ */
+-(id)valueForNode:(CWFlatTreeNodeID)node;
+
+/**
+ Replaces the value of node
+ 
+ @param value the new value, may be nil
+ @param node the ID of an existing node. An assertion is thrown if invalid.
+ */
+-(void)setValue:(id)value forNode:(CWFlatTreeNodeID)node;
+
+/**
+ Returns the parent of node or kCWFlatTreeNoNode for the root node
+ */
+-(CWFlatTreeNodeID)parentOfNode:(CWFlatTreeNodeID)node;
+
+/**
+ Returns the first child of node or kCWFlatTreeNoNode if it has no children
+ */
+-(CWFlatTreeNodeID)firstChildOfNode:(CWFlatTreeNodeID)node;
+
+/**
+ Returns the next sibling of node or kCWFlatTreeNoNode if it is the last child
+ */
+-(CWFlatTreeNodeID)nextSiblingOfNode:(CWFlatTreeNodeID)node;
+
+/**
+ Returns the number of children node has
+ */
+-(NSUInteger)childCountOfNode:(CWFlatTreeNodeID)node;
+
+/**
+ Returns the depth level of node, the root node being level 1
+ 
+ This matches -[CWTreeNode nodeLevel] but is a stored value not a computed one.
+ */
+-(NSUInteger)levelOfNode:(CWFlatTreeNodeID)node;
+
+/**
+ Enumerates the receiver on a level by level basis
+ 
+ This visits the nodes in the same order as -[CWTree enumerateTreeWithBlock:].
+ Nodes the block adds to the receiver are not visited.
+ 
+ @param nodeValue the value of the node being enumerated over
+ @param node the ID of the node being enumerated over
+ @param stop set this to YES to stop enumeration at any time
+ */
+-(void)enumerateTreeWithBlock:(void (^)(id nodeValue, CWFlatTreeNodeID node, BOOL *stop))block;
+
+/**
+ Enumerates all nodes in the order they are stored in, which is ID order
+ 
+ This is the fastest way to visit every node as it walks storage sequentially.
+ Parents are always visited before their children. Nodes the block adds to the
+ receiver are not visited.
+ 
+ @param nodeValue the value of the node being enumerated over
+ @param node the ID of the node being enumerated over
+ @param stop set this to YES to stop enumeration at any time
+ */
+-(void)enumerateNodesInStorageOrderWithBlock:(void (^)(id nodeValue, CWFlatTreeNodeID node, BOOL *stop))block;
+
+@end
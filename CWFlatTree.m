@@ -0,0 +1,290 @@
+/*
+//  CWFlatTree.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWFlatTree.h"
+#import "CWTree.h"
+#import "CWAssertionMacros.h"
+
+#define kCWFlatTreeInitialCapacity 16
+#define kCWFlatTreeNil UINT32_MAX
+
+/**
+ The storage record for a single node. Node ID's are stored as 32 bit indexes
+ to keep the record small, which limits a tree to UINT32_MAX - 1 nodes.
+ */
+typedef struct {
+	uint32_t parent;
+	uint32_t firstChild;
+	uint32_t lastChild;
+	uint32_t nextSibling;
+	uint32_t childCount;
+	uint32_t level;
+} CWFlatTreeRecord;
+
+#define CWFlatTreeNodeIDFromIndex(index) (((index) == kCWFlatTreeNil) ? kCWFlatTreeNoNode : (CWFlatTreeNodeID)(index))
+
+@implementation CWFlatTree {
+	CWFlatTreeRecord *_records;
+	//retained node values, stored apart from the records so walks stay compact
+	void **_values;
+	NSUInteger _count;
+	NSUInteger _capacity;
+}
+
+-(instancetype)init {
+	self = [super init];
+	if (self == nil) return nil;
+	
+	_records = NULL;
+	_values = NULL;
+	_count = 0;
+	_capacity = 0;
+	
+	return self;
+}
+
+-(instancetype)initWithRootValue:(id)value {
+	self = [self init];
+	if (self == nil) return nil;
+	
+	[self _appendNodeWithValue:value parent:kCWFlatTreeNil level:1];
+	
+	return self;
+}
+
+-(instancetype)initWithTree:(CWTree *)tree {
+	self = [self init];
+	if (self == nil) return nil;
+	
+	CWTreeNode *root = tree.rootNode;
+	if (root == nil) return self;
+	
+	//copy level by level keeping the CWTreeNodes & their new ID's side by side
+	NSMutableArray *level = [NSMutableArray arrayWithObject:root];
+	NSMutableArray *levelIDs = [NSMutableArray arrayWithObject:@([self _appendNodeWithValue:root.value
+																					  parent:kCWFlatTreeNil
+																					   level:1])];
+	while (level.count > 0) {
+		NSMutableArray *nextLevel = [NSMutableArray array];
+		NSMutableArray *nextLevelIDs = [NSMutableArray array];
+		[level enumerateObjectsUsingBlock:^(CWTreeNode *node, NSUInteger idx, BOOL *stop) {
+			CWFlatTreeNodeID parentID = [levelIDs[idx] unsignedIntegerValue];
+			for (CWTreeNode *child in node.children) {
+				[nextLevel addObject:child];
+				[nextLevelIDs addObject:@([self addChildWithValue:child.value toNode:parentID])];
+			}
+		}];
+		level = nextLevel;
+		levelIDs = nextLevelIDs;
+	}
+	
+	return self;
+}
+
+-(void)dealloc {
+	for (NSUInteger i = 0; i < _count; i++) {
+		if (_values[i]) (void)(__bridge_transfer id)_values[i];
+	}
+	free(_values);
+	free(_records);
+}
+
+-(NSString *)description {
+	return [NSString stringWithFormat:@"%@: Node Count: %lu\nStorage Size: %lu bytes",
+			NSStringFromClass([self class]),
+			(unsigned long)self.count,
+			(unsigned long)self.storageSize];
+}
+
+#pragma mark Storage -
+
+-(NSUInteger)count {
+	return _count;
+}
+
+-(NSUInteger)storageSize {
+	return _capacity * (sizeof(CWFlatTreeRecord) + sizeof(void *));
+}
+
+-(void)reserveCapacity:(NSUInteger)capacity {
+	if (capacity <= _capacity) return;
+	CWAssert(capacity < kCWFlatTreeNil);
+	//keep each block as soon as it has moved, so a failure leaves no ivar
+	//pointing at a block realloc already freed
+	CWFlatTreeRecord *records = realloc(_records, capacity * sizeof(CWFlatTreeRecord));
+	CWAssert(records != NULL);
+	_records = records;
+	void **values = realloc(_values, capacity * sizeof(void *));
+	CWAssert(values != NULL);
+	_values = values;
+	_capacity = capacity;
+}
+
+-(uint32_t)_appendNodeWithValue:(id)value
+						 parent:(uint32_t)parent
+						  level:(uint32_t)level {
+	if (_count == _capacity) {
+		[self reserveCapacity:MAX(_capacity * 2, (NSUInteger)kCWFlatTreeInitialCapacity)];
+	}
+	uint32_t index = (uint32_t)_count;
+	_records[index] = (CWFlatTreeRecord){
+		.parent = parent,
+		.firstChild = kCWFlatTreeNil,
+		.lastChild = kCWFlatTreeNil,
+		.nextSibling = kCWFlatTreeNil,
+		.childCount = 0,
+		.level = level
+	};
+	_values[index] = (value != nil) ? (__bridge_retained void *)value : NULL;
+	_count++;
+	return index;
+}
+
+#pragma mark Nodes -
+
+-(CWFlatTreeNodeID)rootNode {
+	return (_count > 0) ? 0 : kCWFlatTreeNoNode;
+}
+
+-(CWFlatTreeNodeID)addChildWithValue:(id)value toNode:(CWFlatTreeNodeID)parent {
+	CWAssert(parent < _count);
+	uint32_t parentIndex = (uint32_t)parent;
+	uint32_t child = [self _appendNodeWithValue:value
+										 parent:parentIndex
+										  level:_records[parentIndex].level + 1];
+	//look the parent up again, appending may have moved the records
+	CWFlatTreeRecord *parentRecord = &_records[parentIndex];
+	if (parentRecord->lastChild == kCWFlatTreeNil) {
+		parentRecord->firstChild = child;
+	} else {
+		_records[parentRecord->lastChild].nextSibling = child;
+	}
+	parentRecord->lastChild = child;
+	parentRecord->childCount++;
+	return child;
+}
+
+-(id)valueForNode:(CWFlatTreeNodeID)node {
+	CWAssert(node < _count);
+	return (__bridge id)_values[node];
+}
+
+-(void)setValue:(id)value forNode:(CWFlatTreeNodeID)node {
+	CWAssert(node < _count);
+	void *oldValue = _values[node];
+	_values[node] = (value != nil) ? (__bridge_retained void *)value : NULL;
+	if (oldValue) (void)(__bridge_transfer id)oldValue;
+}
+
+-(CWFlatTreeNodeID)parentOfNode:(CWFlatTreeNodeID)node {
+	CWAssert(node < _count);
+	return CWFlatTreeNodeIDFromIndex(_records[node].parent);
+}
+
+-(CWFlatTreeNodeID)firstChildOfNode:(CWFlatTreeNodeID)node {
+	CWAssert(node < _count);
+	return CWFlatTreeNodeIDFromIndex(_records[node].firstChild);
+}
+
+-(CWFlatTreeNodeID)nextSiblingOfNode:(CWFlatTreeNodeID)node {
+	CWAssert(node < _count);
+	return CWFlatTreeNodeIDFromIndex(_records[node].nextSibling);
+}
+
+-(NSUInteger)childCountOfNode:(CWFlatTreeNodeID)node {
+	CWAssert(node < _count);
+	return _records[node].childCount;
+}
+
+-(NSUInteger)levelOfNode:(CWFlatTreeNodeID)node {
+	CWAssert(node < _count);
+	return _records[node].level;
+}
+
+#pragma mark Enumeration -
+
+-(void)enumerateTreeWithBlock:(void (^)(id nodeValue, CWFlatTreeNodeID node, BOOL *stop))block {
+	CWAssert(block != nil);
+	//nodes added by the block get IDs past count and are left out, so the
+	//queue never holds more than the count nodes that were there to begin with
+	NSUInteger count = _count;
+	if (count == 0) return;
+	
+	//every node is enqueued exactly once so a plain array works as the queue
+	uint32_t *queue = malloc(count * sizeof(uint32_t));
+	CWAssert(queue != NULL);
+	if (queue == NULL) return;
+	NSUInteger head = 0, tail = 0;
+	queue[tail++] = 0;
+	BOOL shouldStop = NO;
+	while (head < tail) {
+		uint32_t node = queue[head++];
+		block((__bridge id)_values[node], node, &shouldStop);
+		if (shouldStop) break;
+		for (uint32_t child = _records[node].firstChild; child != kCWFlatTreeNil; child = _records[child].nextSibling) {
+			if (child < count) queue[tail++] = child;
+		}
+	}
+	free(queue);
+}
+
+-(void)enumerateNodesInStorageOrderWithBlock:(void (^)(id nodeValue, CWFlatTreeNodeID node, BOOL *stop))block {
+	CWAssert(block != nil);
+	NSUInteger count = _count;
+	BOOL shouldStop = NO;
+	for (NSUInteger node = 0; node < count; node++) {
+		block((__bridge id)_values[node], node, &shouldStop);
+		if (shouldStop) break;
+	}
+}
+
+#pragma mark CWTree Conversion -
+
+-(CWTree *)tree {
+	CWTree *tree = [[CWTree alloc] init];
+	if (_count == 0) return tree;
+	
+	//nodes are stored parents first so one pass in ID order builds the tree
+	NSMutableArray *nodes = [NSMutableArray arrayWithCapacity:_count];
+	for (NSUInteger i = 0; i < _count; i++) {
+		CWTreeNode *node = [[CWTreeNode alloc] initWithValue:(__bridge id)_values[i]];
+		node.allowsDuplicates = YES;
+		[nodes addObject:node];
+		if (_records[i].parent != kCWFlatTreeNil) {
+			[(CWTreeNode *)nodes[_records[i].parent] addChild:node];
+		}
+	}
+	tree.rootNode = nodes[0];
+	return tree;
+}
+
+@end
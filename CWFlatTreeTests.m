@@ -0,0 +1,134 @@
+/*
+//  CWFlatTreeTests.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWFlatTree.h"
+#import "CWTree.h"
+
+SpecBegin(CWFlatTree)
+
+describe(@"building a tree", ^{
+	it(@"should link parents, children & siblings", ^{
+		CWFlatTree *tree = [[CWFlatTree alloc] initWithRootValue:@"1"];
+		CWFlatTreeNodeID root = [tree rootNode];
+		CWFlatTreeNodeID node2 = [tree addChildWithValue:@"2" toNode:root];
+		CWFlatTreeNodeID node3 = [tree addChildWithValue:@"3" toNode:root];
+		CWFlatTreeNodeID node4 = [tree addChildWithValue:@"4" toNode:node2];
+		
+		expect(tree.count).to.equal(4);
+		expect([tree parentOfNode:root]).to.equal(kCWFlatTreeNoNode);
+		expect([tree parentOfNode:node4]).to.equal(node2);
+		expect([tree firstChildOfNode:root]).to.equal(node2);
+		expect([tree nextSiblingOfNode:node2]).to.equal(node3);
+		expect([tree nextSiblingOfNode:node3]).to.equal(kCWFlatTreeNoNode);
+		expect([tree childCountOfNode:root]).to.equal(2);
+		expect([tree levelOfNode:node4]).to.equal(3);
+		expect([tree valueForNode:node3]).to.equal(@"3");
+	});
+	
+	it(@"should have no nodes when made from a tree without a root node", ^{
+		CWFlatTree *tree = [[CWFlatTree alloc] initWithTree:[[CWTree alloc] init]];
+		
+		expect(tree.count).to.equal(0);
+		expect([tree rootNode]).to.equal(kCWFlatTreeNoNode);
+	});
+});
+
+describe(@"-enumerateTreeWithBlock", ^{
+	it(@"should enumerate nodes level by level like CWTree", ^{
+		/**
+		       1
+		   ----|----
+		   2       3
+		 --|--     |
+		 4   5     6
+		 
+		 node 6 is added before nodes 4 & 5 so storage order differs from
+		 level order
+		 */
+		CWFlatTree *tree = [[CWFlatTree alloc] initWithRootValue:@"1"];
+		CWFlatTreeNodeID node2 = [tree addChildWithValue:@"2" toNode:[tree rootNode]];
+		CWFlatTreeNodeID node3 = [tree addChildWithValue:@"3" toNode:[tree rootNode]];
+		[tree addChildWithValue:@"6" toNode:node3];
+		[tree addChildWithValue:@"4" toNode:node2];
+		[tree addChildWithValue:@"5" toNode:node2];
+		
+		NSMutableString *result = [NSMutableString string];
+		[tree enumerateTreeWithBlock:^(id nodeValue, CWFlatTreeNodeID node, BOOL *stop) {
+			[result appendString:nodeValue];
+		}];
+		
+		expect(result).to.equal(@"123456");
+	});
+	
+	it(@"should not visit nodes the block adds", ^{
+		CWFlatTree *tree = [[CWFlatTree alloc] initWithRootValue:@"1"];
+		[tree addChildWithValue:@"2" toNode:[tree rootNode]];
+		
+		NSMutableString *result = [NSMutableString string];
+		[tree enumerateTreeWithBlock:^(id nodeValue, CWFlatTreeNodeID node, BOOL *stop) {
+			[result appendString:nodeValue];
+			[tree addChildWithValue:@"x" toNode:node];
+		}];
+		
+		expect(result).to.equal(@"12");
+		expect(tree.count).to.equal(4);
+	});
+});
+
+describe(@"CWTree conversion", ^{
+	it(@"should round trip a CWTree", ^{
+		CWTree *tree = [[CWTree alloc] initWithRootNodeValue:@"1"];
+		CWTreeNode *node2 = [[CWTreeNode alloc] initWithValue:@"2"];
+		[[tree rootNode] addChild:node2];
+		[[tree rootNode] addChild:[[CWTreeNode alloc] initWithValue:@"3"]];
+		[node2 addChild:[[CWTreeNode alloc] initWithValue:@"4"]];
+		
+		CWFlatTree *flatTree = [[CWFlatTree alloc] initWithTree:tree];
+		
+		expect(flatTree.count).to.equal(4);
+		
+		CWTree *copy = [flatTree tree];
+		NSMutableString *original = [NSMutableString string];
+		NSMutableString *copied = [NSMutableString string];
+		[tree enumerateTreeWithBlock:^(id nodeValue, id node, BOOL *stop) {
+			[original appendString:nodeValue];
+		}];
+		[copy enumerateTreeWithBlock:^(id nodeValue, id node, BOOL *stop) {
+			[copied appendString:nodeValue];
+		}];
+		
+		expect(copied).to.equal(original);
+		expect([[copy rootNode].children[0] children].count).to.equal(1);
+	});
+});
+
+SpecEnd
@@ -0,0 +1,157 @@
+/*
+//  CWInt64PriorityQueue.h
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+ /*
+ This class should not make any use of the Zangetsu Framework API's so it can
+ retain its independence and be used in other projects not making use of the
+ Zangetsu Framework.
+  */
+
+#import <Foundation/Foundation.h>
+#import "CWStatistics.h"
+
+/**
+ CWInt64PriorityQueue
+ 
+ CWInt64PriorityQueue is a CWPriorityQueue for int64_t values with int64_t
+ priorities. Entries are stored unboxed in a binary heap in one contiguous
+ block of memory, so adding is O(log n) rather than a sort of the whole queue
+ & no wrapper object is created per entry. As with CWPriorityQueue the lower
+ an entries priority number is the sooner it is dequeued, entries with equal
+ priorities are dequeued in the order they were added.
+ 
+ Like CWPriorityQueue this class is not thread safe.
+ */
+
+@interface CWInt64PriorityQueue : NSObject
+
+/**
+ Adds value to the queue with priority
+ 
+ @param value the value to add
+ @param priority the priority of value, lower numbers are dequeued first
+ */
+-(void)addValue:(int64_t)value
+   withPriority:(int64_t)priority;
+
+/**
+ Removes all values from the queue
+ */
+-(void)removeAllValues;
+
+/**
+ Returns the number of values in the queue
+ 
+ @return a NSUInteger with the number of values in the queue
+ */
+-(NSUInteger)count;
+
+/**
+ Returns the next value to be dequeued without removing it
+ 
+ @param value set to the next value if the queue isn't empty, may be NULL
+ @param priority set to the priority of the next value, may be NULL
+ @return YES if the queue had a value, NO if the queue was empty
+ */
+-(BOOL)peekValue:(int64_t *)value priority:(int64_t *)priority;
+
+/**
+ Dequeues the value with the highest priority (the lowest priority number)
+ 
+ @param value set to the dequeued value if the queue isn't empty, may be NULL
+ @param priority set to the priority of the dequeued value, may be NULL
+ @return YES if a value was dequeued, NO if the queue was empty
+ */
+-(BOOL)dequeueValue:(int64_t *)value priority:(int64_t *)priority;
+
+/**
+ Dequeues the values of the next priority level off the queue
+ 
+ This is the unboxed version of -[CWPriorityQueue 
+ dequeueAllObjectsOfNextPriorityLevel]. It looks at the highest priority of the
+ values in the queue & dequeues values of that priority, in the order they were
+ added, until there are none left or maxCount values have been dequeued. Use
+ -peekValue:priority: & -countOfValuesWithPriority: to size values so the 
+ whole level is dequeued.
+ 
+ @param values a C array with room for at least maxCount values which the
+ dequeued values are copied into
+ @param maxCount the largest number of values to dequeue
+ @param priority set to the priority of the dequeued values, may be NULL
+ @return the number of values dequeued, 0 if the queue was empty
+ */
+-(NSUInteger)dequeueValuesOfNextPriorityLevel:(int64_t *)values
+									 maxCount:(NSUInteger)maxCount
+									 priority:(int64_t *)priority;
+
+/**
+ Copies the values in the queue with the given priority without removing them
+ 
+ This is the unboxed version of -[CWPriorityQueue allObjectsOfPriority:]. The
+ values are copied in the order they were added, if there are more than
+ maxCount values with the priority only the first maxCount are copied. Use
+ -countOfValuesWithPriority: to size values so all of them are copied.
+ 
+ @param values a C array with room for at least maxCount values
+ @param maxCount the largest number of values to copy
+ @param priority the priority level to copy the values of
+ @return the number of values copied
+ */
+-(NSUInteger)getValues:(int64_t *)values
+			  maxCount:(NSUInteger)maxCount
+		  withPriority:(int64_t)priority;
+
+/**
+ Returns the count of all values in the queue with the given priority
+ 
+ @param priority the priority level to count values for
+ @return a NSUInteger with the number of values with the given priority
+ */
+-(NSUInteger)countOfValuesWithPriority:(int64_t)priority;
+
+#if CW_STATISTICS
+
+/**
+ Returns the statistics the queue has kept since it was created
+ 
+ The dictionary contains addCount, dequeueCount (including values removed by
+ -dequeueValuesOfNextPriorityLevel:maxCount:priority:), emptyDequeueCount
+ (dequeues of an empty queue), peekCount & highWaterCount (the most values the
+ queue has held at once). Only available when CW_STATISTICS is set to 1.
+ 
+ @return a NSDictionary with the queue's statistics
+ */
+-(NSDictionary *)statistics;
+
+#endif
+
+@end
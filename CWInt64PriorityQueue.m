@@ -0,0 +1,230 @@
+/*
+//  CWInt64PriorityQueue.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWInt64PriorityQueue.h"
+#import "CWAssertionMacros.h"
+#import "CWStatistics.h"
+
+#define kCWInt64PriorityQueueMinimumCapacity 16
+
+typedef struct CWInt64PriorityQueueEntry {
+	int64_t priority;
+	int64_t value;
+	//breaks ties between equal priorities so they dequeue in insertion order
+	uint64_t sequence;
+} CWInt64PriorityQueueEntry;
+
+static int CWInt64PriorityQueueCompareSequence(const void *a, const void *b) {
+	uint64_t aSequence = ((const CWInt64PriorityQueueEntry *)a)->sequence;
+	uint64_t bSequence = ((const CWInt64PriorityQueueEntry *)b)->sequence;
+	return (aSequence > bSequence) - (aSequence < bSequence);
+}
+
+static inline BOOL CWInt64PriorityQueueEntryBefore(const CWInt64PriorityQueueEntry *a,
+												   const CWInt64PriorityQueueEntry *b) {
+	if (a->priority != b->priority) return (a->priority < b->priority);
+	return (a->sequence < b->sequence);
+}
+
+#if CW_STATISTICS
+typedef struct CWInt64PriorityQueueStatistics {
+	uint64_t addCount;
+	uint64_t dequeueCount;
+	uint64_t emptyDequeueCount;
+	uint64_t peekCount;
+	uint64_t highWaterCount;
+} CWInt64PriorityQueueStatistics;
+#endif
+
+@interface CWInt64PriorityQueue () {
+	CWInt64PriorityQueueEntry *_heap;
+	NSUInteger _capacity;
+	NSUInteger _count;
+	uint64_t _nextSequence;
+#if CW_STATISTICS
+	CWInt64PriorityQueueStatistics _statistics;
+#endif
+}
+@end
+
+@implementation CWInt64PriorityQueue
+
+-(instancetype)init {
+	self = [super init];
+	if (self == nil) return nil;
+	
+	//storage is allocated by the first add
+	_heap = NULL;
+	_capacity = 0;
+	_count = 0;
+	_nextSequence = 0;
+	
+	return self;
+}
+
+-(void)dealloc {
+	free(_heap);
+}
+
+-(NSString *)description {
+	return [NSString stringWithFormat:@"%@: %lu values",
+			NSStringFromClass([self class]), (unsigned long)_count];
+}
+
+-(void)addValue:(int64_t)value
+   withPriority:(int64_t)priority {
+	if (_count == _capacity) {
+		NSUInteger capacity = MAX(_capacity * 2, (NSUInteger)kCWInt64PriorityQueueMinimumCapacity);
+		CWInt64PriorityQueueEntry *heap = realloc(_heap, capacity * sizeof(CWInt64PriorityQueueEntry));
+		CWAssert(heap != NULL);
+		_heap = heap;
+		_capacity = capacity;
+	}
+	
+	CWInt64PriorityQueueEntry entry = { priority, value, _nextSequence++ };
+	//sift up, moving parents down into the hole until entry fits
+	NSUInteger index = _count++;
+	while (index > 0) {
+		NSUInteger parent = (index - 1) / 2;
+		if (!CWInt64PriorityQueueEntryBefore(&entry, &_heap[parent])) break;
+		_heap[index] = _heap[parent];
+		index = parent;
+	}
+	_heap[index] = entry;
+	CWStatisticsCount(_statistics.addCount);
+	CWStatisticsHighWater(_statistics.highWaterCount, _count);
+}
+
+-(void)removeAllValues {
+	_count = 0;
+}
+
+-(NSUInteger)count {
+	return _count;
+}
+
+-(BOOL)peekValue:(int64_t *)value priority:(int64_t *)priority {
+	CWStatisticsCount(_statistics.peekCount);
+	if (_count == 0) return NO;
+	if (value) *value = _heap[0].value;
+	if (priority) *priority = _heap[0].priority;
+	return YES;
+}
+
+-(BOOL)dequeueValue:(int64_t *)value priority:(int64_t *)priority {
+	if (_count == 0) {
+		CWStatisticsCount(_statistics.emptyDequeueCount);
+		return NO;
+	}
+	CWStatisticsCount(_statistics.dequeueCount);
+	if (value) *value = _heap[0].value;
+	if (priority) *priority = _heap[0].priority;
+	
+	_count--;
+	if (_count == 0) return YES;
+	
+	//sift the last entry down from the root, moving children up into the hole
+	CWInt64PriorityQueueEntry entry = _heap[_count];
+	NSUInteger index = 0;
+	while (YES) {
+		NSUInteger child = (index * 2) + 1;
+		if (child >= _count) break;
+		if ((child + 1) < _count && CWInt64PriorityQueueEntryBefore(&_heap[child + 1], &_heap[child])) child++;
+		if (!CWInt64PriorityQueueEntryBefore(&_heap[child], &entry)) break;
+		_heap[index] = _heap[child];
+		index = child;
+	}
+	_heap[index] = entry;
+	return YES;
+}
+
+-(NSUInteger)dequeueValuesOfNextPriorityLevel:(int64_t *)values
+									 maxCount:(NSUInteger)maxCount
+									 priority:(int64_t *)priority {
+	CWAssert(values != NULL || maxCount == 0);
+	if (_count == 0 || maxCount == 0) return 0;
+	
+	//entries of equal priority come off the heap in the order they were added
+	int64_t level = _heap[0].priority;
+	if (priority) *priority = level;
+	NSUInteger count = 0;
+	while (count < maxCount && _count > 0 && _heap[0].priority == level) {
+		[self dequeueValue:&values[count++] priority:NULL];
+	}
+	return count;
+}
+
+-(NSUInteger)getValues:(int64_t *)values
+			  maxCount:(NSUInteger)maxCount
+		  withPriority:(int64_t)priority {
+	CWAssert(values != NULL || maxCount == 0);
+	NSUInteger matches = [self countOfValuesWithPriority:priority];
+	if (matches == 0 || maxCount == 0) return 0;
+	
+	//the heap isn't in insertion order, so gather the matches & sort them
+	CWInt64PriorityQueueEntry *entries = malloc(matches * sizeof(CWInt64PriorityQueueEntry));
+	CWAssert(entries != NULL);
+	if (entries == NULL) return 0;
+	NSUInteger found = 0;
+	for (NSUInteger i = 0; i < _count; i++) {
+		if (_heap[i].priority == priority) entries[found++] = _heap[i];
+	}
+	qsort(entries, found, sizeof(CWInt64PriorityQueueEntry), CWInt64PriorityQueueCompareSequence);
+	NSUInteger count = MIN(found, maxCount);
+	for (NSUInteger i = 0; i < count; i++) values[i] = entries[i].value;
+	free(entries);
+	return count;
+}
+
+-(NSUInteger)countOfValuesWithPriority:(int64_t)priority {
+	NSUInteger count = 0;
+	for (NSUInteger i = 0; i < _count; i++) {
+		if (_heap[i].priority == priority) count++;
+	}
+	return count;
+}
+
+#if CW_STATISTICS
+
+#pragma mark Statistics -
+
+-(NSDictionary *)statistics {
+	return @{ @"addCount" : @(CWStatisticsLoad(&_statistics.addCount)),
+			  @"dequeueCount" : @(CWStatisticsLoad(&_statistics.dequeueCount)),
+			  @"emptyDequeueCount" : @(CWStatisticsLoad(&_statistics.emptyDequeueCount)),
+			  @"peekCount" : @(CWStatisticsLoad(&_statistics.peekCount)),
+			  @"highWaterCount" : @(CWStatisticsLoad(&_statistics.highWaterCount)) };
+}
+
+#endif
+
+@end
@@ -0,0 +1,146 @@
+/*
+//  CWInt64PriorityQueueTests.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWInt64PriorityQueue.h"
+
+SpecBegin(CWInt64PriorityQueue)
+
+it(@"should dequeue values by priority", ^{
+	CWInt64PriorityQueue *queue = [CWInt64PriorityQueue new];
+	[queue addValue:30 withPriority:3];
+	[queue addValue:10 withPriority:1];
+	[queue addValue:20 withPriority:2];
+	[queue addValue:-10 withPriority:-1];
+	
+	int64_t value = 0, priority = 0;
+	expect([queue peekValue:&value priority:&priority]).to.beTruthy();
+	expect(value == -10 && priority == -1).to.beTruthy();
+	
+	int64_t expected[] = { -10, 10, 20, 30 };
+	for (NSUInteger i = 0; i < 4; i++) {
+		expect([queue dequeueValue:&value priority:NULL]).to.beTruthy();
+		expect(value == expected[i]).to.beTruthy();
+	}
+	expect([queue dequeueValue:&value priority:&priority]).to.beFalsy();
+});
+
+it(@"should dequeue values of equal priority in the order they were added", ^{
+	CWInt64PriorityQueue *queue = [CWInt64PriorityQueue new];
+	for (int64_t i = 0; i < 100; i++) [queue addValue:i withPriority:i % 3];
+	
+	int64_t value = 0, priority = 0, lastPriority = 0, lastValue = -1;
+	while ([queue dequeueValue:&value priority:&priority]) {
+		if (priority != lastPriority) lastValue = -1;
+		expect(priority >= lastPriority).to.beTruthy();
+		expect(value > lastValue).to.beTruthy();
+		lastPriority = priority;
+		lastValue = value;
+	}
+});
+
+it(@"should dequeue all values of the next priority level", ^{
+	CWInt64PriorityQueue *queue = [CWInt64PriorityQueue new];
+	[queue addValue:1 withPriority:2];
+	[queue addValue:2 withPriority:1];
+	[queue addValue:3 withPriority:2];
+	[queue addValue:4 withPriority:1];
+	[queue addValue:5 withPriority:1];
+	
+	int64_t values[8] = { 0 };
+	int64_t priority = 0;
+	expect([queue dequeueValuesOfNextPriorityLevel:values maxCount:8 priority:&priority] == 3).to.beTruthy();
+	expect(priority == 1).to.beTruthy();
+	expect(values[0] == 2 && values[1] == 4 && values[2] == 5).to.beTruthy();
+	
+	expect([queue dequeueValuesOfNextPriorityLevel:values maxCount:1 priority:&priority] == 1).to.beTruthy();
+	expect(priority == 2 && values[0] == 1).to.beTruthy();
+	expect(queue.count == 1).to.beTruthy();
+	
+	[queue removeAllValues];
+	expect([queue dequeueValuesOfNextPriorityLevel:values maxCount:8 priority:NULL] == 0).to.beTruthy();
+});
+
+it(@"should copy the values of a priority in the order they were added", ^{
+	CWInt64PriorityQueue *queue = [CWInt64PriorityQueue new];
+	for (int64_t i = 0; i < 30; i++) [queue addValue:i withPriority:i % 3];
+	
+	int64_t values[16] = { 0 };
+	expect([queue getValues:values maxCount:16 withPriority:1] == 10).to.beTruthy();
+	for (NSUInteger i = 0; i < 10; i++) {
+		expect(values[i] == (int64_t)(i * 3) + 1).to.beTruthy();
+	}
+	expect([queue getValues:values maxCount:2 withPriority:2] == 2).to.beTruthy();
+	expect(values[0] == 2 && values[1] == 5).to.beTruthy();
+	expect([queue getValues:values maxCount:16 withPriority:7] == 0).to.beTruthy();
+	expect(queue.count == 30).to.beTruthy();
+});
+
+it(@"should return the correct counts", ^{
+	CWInt64PriorityQueue *queue = [CWInt64PriorityQueue new];
+	[queue addValue:1 withPriority:5];
+	[queue addValue:2 withPriority:5];
+	[queue addValue:3 withPriority:7];
+	
+	expect(queue.count == 3).to.beTruthy();
+	expect([queue countOfValuesWithPriority:5] == 2).to.beTruthy();
+	expect([queue countOfValuesWithPriority:6] == 0).to.beTruthy();
+	
+	[queue removeAllValues];
+	expect(queue.count == 0).to.beTruthy();
+});
+
+#if CW_STATISTICS
+
+describe(@"-statistics", ^{
+	it(@"should count operations & the high water mark", ^{
+		CWInt64PriorityQueue *queue = [CWInt64PriorityQueue new];
+		[queue addValue:1 withPriority:2];
+		[queue addValue:2 withPriority:1];
+		[queue addValue:3 withPriority:1];
+		[queue peekValue:NULL priority:NULL];
+		int64_t values[4];
+		[queue dequeueValuesOfNextPriorityLevel:values maxCount:4 priority:NULL];
+		[queue dequeueValue:NULL priority:NULL];
+		[queue dequeueValue:NULL priority:NULL];
+		
+		NSDictionary *statistics = queue.statistics;
+		expect(statistics[@"addCount"]).to.equal(@3);
+		expect(statistics[@"dequeueCount"]).to.equal(@3);
+		expect(statistics[@"emptyDequeueCount"]).to.equal(@1);
+		expect(statistics[@"peekCount"]).to.equal(@1);
+		expect(statistics[@"highWaterCount"]).to.equal(@3);
+	});
+});
+
+#endif
+
+SpecEnd
@@ -0,0 +1,186 @@
+/*
+//  CWInt64Queue.h
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+ /*
+ This class should not make any use of the Zangetsu Framework API's so it can
+ retain its independence and be used in other projects not making use of the
+ Zangetsu Framework.
+  */
+
+#import <Foundation/Foundation.h>
+#import "CWStatistics.h"
+
+/**
+ CWInt64Queue is a Thread Safe Class
+ 
+ CWInt64Queue is a CWQueue for int64_t values. Values are stored unboxed in a
+ contiguous ring buffer, so enqueueing & dequeueing never allocates (beyond
+ growing the buffer) or retains anything. Use it in place of a CWQueue of
+ NSNumbers for ID's, offsets, timestamps & the like.
+ 
+ Like CWQueue it takes a lock embedded in the instance around every operation,
+ queues only used from one thread at a time can be created with
+ -initWithSynchronization:NO to skip locking entirely.
+ */
+
+@interface CWInt64Queue : NSObject
+
+/**
+ Initializes an empty CWInt64Queue object
+ 
+ @param synchronized if YES the queue locks around every operation & is safe
+ to use from multiple threads, this is what -init does. If NO the queue does
+ no locking & must only be used from one thread at a time.
+ @return an initialized CWInt64Queue object
+ */
+-(instancetype)initWithSynchronization:(BOOL)synchronized;
+
+/**
+ Initializes a CWInt64Queue object with count values
+ 
+ The values will be dequeued in the same order they are in values, starting at
+ values[0].
+ 
+ @param values a C array of values to initialize the contents of the queue with
+ @param count the number of values in values
+ @return an initialized CWInt64Queue object
+ */
+-(instancetype)initWithValues:(const int64_t *)values count:(NSUInteger)count;
+
+/**
+ Returns if the queue was created with synchronization
+ */
+@property(readonly, getter=isSynchronized) BOOL synchronized;
+
+/**
+ Enqueues value onto the receiving queue
+ 
+ @param value the value to be enqueued
+ */
+-(void)enqueueValue:(int64_t)value;
+
+/**
+ Enqueues count values onto the receiving queue in order
+ 
+ @param values a C array of values to be enqueued
+ @param count the number of values in values
+ */
+-(void)enqueueValues:(const int64_t *)values count:(NSUInteger)count;
+
+/**
+ Removes all values from the receiving queue
+ */
+-(void)removeAllValues;
+
+/**
+ Dequeues the value at the front of the queue
+ 
+ @param value if the queue isn't empty this is set to the dequeued value, may
+ be NULL
+ @return YES if a value was dequeued, NO if the queue was empty
+ */
+-(BOOL)dequeueValue:(int64_t *)value;
+
+/**
+ Dequeues up to maxCount values from the front of the queue in one operation
+ 
+ @param values a C array with room for at least maxCount values which the
+ dequeued values are copied into
+ @param maxCount the largest number of values to dequeue
+ @return the number of values dequeued
+ */
+-(NSUInteger)dequeueValues:(int64_t *)values maxCount:(NSUInteger)maxCount;
+
+/**
+ Returns the value at the front of the queue without dequeueing it
+ 
+ @param value if the queue isn't empty this is set to the front value
+ @return YES if the queue had a value, NO if the queue was empty
+ */
+-(BOOL)peekValue:(int64_t *)value;
+
+/**
+ Returns a BOOL indicating if the queue contains value
+ 
+ @param value the value to search for
+ @return YES if the queue contains value, otherwise NO
+ */
+-(BOOL)containsValue:(int64_t)value;
+
+/**
+ Enumerates the values in the queue from front to back without dequeueing them
+ 
+ @param block the block called for each value. Set stop to YES to stop
+ enumerating.
+ */
+-(void)enumerateValuesInQueue:(void (^)(int64_t value, BOOL *stop))block;
+
+/**
+ Returns the number of values in the queue
+ 
+ @return a NSUInteger with the receiving queues value count
+ */
+-(NSUInteger)count;
+
+/**
+ Returns a BOOL indicating if the queue is empty
+ 
+ @return YES if the queues count is 0, otherwise NO
+ */
+-(BOOL)isEmpty;
+
+/**
+ Returns a BOOL indicating if queue holds the same values in the same order
+ 
+ @param queue the queue to compare against
+ @return YES if the queues are equal, otherwise NO
+ */
+-(BOOL)isEqualToInt64Queue:(CWInt64Queue *)queue;
+
+#if CW_STATISTICS
+
+/**
+ Returns the statistics the queue has kept since it was created
+ 
+ The dictionary contains enqueueCount, dequeueCount (values dequeued),
+ emptyDequeueCount (dequeues of an empty queue), peekCount, highWaterCount
+ (the most values the queue has held at once) & waitTime, a histogram of the
+ time each call waited for the queue's lock. Only available when CW_STATISTICS
+ is set to 1.
+ 
+ @return a NSDictionary with the queue's statistics
+ */
+-(NSDictionary *)statistics;
+
+#endif
+
+@end
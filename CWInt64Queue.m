@@ -0,0 +1,323 @@
+/*
+//  CWInt64Queue.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWInt64Queue.h"
+#import "CWAssertionMacros.h"
+#import "CWLock.h"
+
+//capacities are always a power of 2 so wrapping an index is a mask
+#define kCWInt64QueueMinimumCapacity 16
+
+#if CW_STATISTICS
+typedef struct CWInt64QueueStatistics {
+	uint64_t enqueueCount;
+	uint64_t dequeueCount;
+	uint64_t emptyDequeueCount;
+	uint64_t peekCount;
+	uint64_t highWaterCount;
+	CWStatisticsWaitHistogram wait;
+} CWInt64QueueStatistics;
+#endif
+
+@interface CWInt64Queue () {
+	CWLock _lock;
+	int64_t *_values;
+	NSUInteger _capacity;
+	NSUInteger _head;
+	NSUInteger _count;
+#if CW_STATISTICS
+	CWInt64QueueStatistics _statistics;
+#endif
+}
+@end
+
+#define CWInt64QueueLock() CWLockAcquire(&_lock, _synchronized, _statistics.wait)
+#define CWInt64QueueUnlock() CWLockRelease(&_lock, _synchronized)
+#define CWInt64QueueIndex(index) ((_head + (index)) & (_capacity - 1))
+
+@implementation CWInt64Queue
+
+#pragma mark Initialization -
+
+-(instancetype)init {
+	return [self initWithSynchronization:YES];
+}
+
+-(instancetype)initWithSynchronization:(BOOL)synchronized {
+	self = [super init];
+	if (self == nil) return nil;
+	
+	//storage is allocated by the first enqueue
+	_values = NULL;
+	_capacity = 0;
+	_head = 0;
+	_count = 0;
+	_synchronized = synchronized;
+	CWLockInit(&_lock);
+	
+	return self;
+}
+
+-(instancetype)initWithValues:(const int64_t *)values count:(NSUInteger)count {
+	self = [self initWithSynchronization:YES];
+	if (self == nil) return nil;
+	
+	if (count > 0) [self _appendValues:values count:count];
+	
+	return self;
+}
+
+-(void)dealloc {
+	free(_values);
+	CWLockDestroy(&_lock);
+}
+
+#pragma mark Storage -
+
+/**
+ Grows the ring buffer so it can hold at least count values, unwrapping the
+ existing values to the start of the new buffer. Must be called with the lock
+ held.
+ */
+-(void)_reserveCapacity:(NSUInteger)count {
+	if (count <= _capacity) return;
+	NSUInteger capacity = MAX(_capacity, (NSUInteger)kCWInt64QueueMinimumCapacity);
+	while (capacity < count) capacity *= 2;
+	int64_t *values = malloc(capacity * sizeof(int64_t));
+	CWAssert(values != NULL);
+	if (_count > 0) {
+		NSUInteger firstRun = MIN(_count, _capacity - _head);
+		memcpy(values, _values + _head, firstRun * sizeof(int64_t));
+		memcpy(values + firstRun, _values, (_count - firstRun) * sizeof(int64_t));
+	}
+	free(_values);
+	_values = values;
+	_capacity = capacity;
+	_head = 0;
+}
+
+/**
+ Appends count values to the back of the ring buffer, must be called with the
+ lock held
+ */
+-(void)_appendValues:(const int64_t *)values count:(NSUInteger)count {
+	[self _reserveCapacity:_count + count];
+	NSUInteger tail = CWInt64QueueIndex(_count);
+	NSUInteger firstRun = MIN(count, _capacity - tail);
+	memcpy(_values + tail, values, firstRun * sizeof(int64_t));
+	memcpy(_values, values + firstRun, (count - firstRun) * sizeof(int64_t));
+	_count += count;
+	CWStatisticsHighWater(_statistics.highWaterCount, _count);
+}
+
+/**
+ Returns a malloc'd copy of the values in order which the caller must free
+ */
+-(int64_t *)_copyValuesWithCount:(NSUInteger *)count {
+	CWInt64QueueLock();
+	int64_t *copy = malloc(MAX(_count, (NSUInteger)1) * sizeof(int64_t));
+	CWAssert(copy != NULL);
+	for (NSUInteger i = 0; i < _count; i++) copy[i] = _values[CWInt64QueueIndex(i)];
+	*count = _count;
+	CWInt64QueueUnlock();
+	return copy;
+}
+
+#pragma mark Add & Remove Values -
+
+-(void)enqueueValue:(int64_t)value {
+	CWInt64QueueLock();
+	if (_count == _capacity) [self _reserveCapacity:_count + 1];
+	_values[CWInt64QueueIndex(_count)] = value;
+	_count++;
+	CWStatisticsCount(_statistics.enqueueCount);
+	CWStatisticsHighWater(_statistics.highWaterCount, _count);
+	CWInt64QueueUnlock();
+}
+
+-(void)enqueueValues:(const int64_t *)values count:(NSUInteger)count {
+	if (count == 0) return;
+	CWAssert(values != NULL);
+	
+	CWInt64QueueLock();
+	[self _appendValues:values count:count];
+	CWStatisticsAdd(_statistics.enqueueCount, count);
+	CWInt64QueueUnlock();
+}
+
+-(void)removeAllValues {
+	CWInt64QueueLock();
+	_head = 0;
+	_count = 0;
+	CWInt64QueueUnlock();
+}
+
+-(BOOL)dequeueValue:(int64_t *)value {
+	BOOL dequeued = NO;
+	CWInt64QueueLock();
+	if (_count > 0) {
+		if (value) *value = _values[_head];
+		_head = (_head + 1) & (_capacity - 1);
+		_count--;
+		dequeued = YES;
+		CWStatisticsCount(_statistics.dequeueCount);
+	} else {
+		CWStatisticsCount(_statistics.emptyDequeueCount);
+	}
+	CWInt64QueueUnlock();
+	return dequeued;
+}
+
+-(NSUInteger)dequeueValues:(int64_t *)values maxCount:(NSUInteger)maxCount {
+	CWAssert(values != NULL || maxCount == 0);
+	
+	CWInt64QueueLock();
+	NSUInteger count = MIN(maxCount, _count);
+	NSUInteger firstRun = MIN(count, _capacity - _head);
+	if (count > 0) {
+		memcpy(values, _values + _head, firstRun * sizeof(int64_t));
+		memcpy(values + firstRun, _values, (count - firstRun) * sizeof(int64_t));
+		_head = CWInt64QueueIndex(count);
+		_count -= count;
+		CWStatisticsAdd(_statistics.dequeueCount, count);
+	} else if (maxCount > 0) {
+		CWStatisticsCount(_statistics.emptyDequeueCount);
+	}
+	CWInt64QueueUnlock();
+	return count;
+}
+
+#pragma mark Query Methods -
+
+-(BOOL)peekValue:(int64_t *)value {
+	CWAssert(value != NULL);
+	
+	BOOL found = NO;
+	CWInt64QueueLock();
+	CWStatisticsCount(_statistics.peekCount);
+	if (_count > 0) {
+		*value = _values[_head];
+		found = YES;
+	}
+	CWInt64QueueUnlock();
+	return found;
+}
+
+-(BOOL)containsValue:(int64_t)value {
+	BOOL contains = NO;
+	CWInt64QueueLock();
+	for (NSUInteger i = 0; i < _count; i++) {
+		if (_values[CWInt64QueueIndex(i)] == value) {
+			contains = YES;
+			break;
+		}
+	}
+	CWInt64QueueUnlock();
+	return contains;
+}
+
+-(void)enumerateValuesInQueue:(void (^)(int64_t value, BOOL *stop))block {
+	CWAssert(block != nil);
+	
+	CWInt64QueueLock();
+	BOOL shouldStop = NO;
+	for (NSUInteger i = 0; i < _count; i++) {
+		block(_values[CWInt64QueueIndex(i)], &shouldStop);
+		if (shouldStop) break;
+	}
+	CWInt64QueueUnlock();
+}
+
+-(NSUInteger)count {
+	CWInt64QueueLock();
+	NSUInteger count = _count;
+	CWInt64QueueUnlock();
+	return count;
+}
+
+-(BOOL)isEmpty {
+	return (self.count == 0);
+}
+
+#pragma mark Comparison -
+
+-(BOOL)isEqualToInt64Queue:(CWInt64Queue *)queue {
+	if (queue == self) return YES;
+	if (queue == nil) return NO;
+	
+	//copy the other queue first so we never hold both locks at once
+	NSUInteger otherCount = 0;
+	int64_t *otherValues = [queue _copyValuesWithCount:&otherCount];
+	
+	BOOL isEqual = NO;
+	CWInt64QueueLock();
+	if (otherCount == _count) {
+		isEqual = YES;
+		for (NSUInteger i = 0; i < _count; i++) {
+			if (_values[CWInt64QueueIndex(i)] != otherValues[i]) {
+				isEqual = NO;
+				break;
+			}
+		}
+	}
+	CWInt64QueueUnlock();
+	free(otherValues);
+	return isEqual;
+}
+
+#pragma mark Debug Information -
+
+-(NSString *)description {
+	NSUInteger count = 0;
+	int64_t *values = [self _copyValuesWithCount:&count];
+	NSMutableArray *numbers = [NSMutableArray arrayWithCapacity:count];
+	for (NSUInteger i = 0; i < count; i++) [numbers addObject:@(values[i])];
+	free(values);
+	return [numbers description];
+}
+
+#if CW_STATISTICS
+
+#pragma mark Statistics -
+
+-(NSDictionary *)statistics {
+	return @{ @"enqueueCount" : @(CWStatisticsLoad(&_statistics.enqueueCount)),
+			  @"dequeueCount" : @(CWStatisticsLoad(&_statistics.dequeueCount)),
+			  @"emptyDequeueCount" : @(CWStatisticsLoad(&_statistics.emptyDequeueCount)),
+			  @"peekCount" : @(CWStatisticsLoad(&_statistics.peekCount)),
+			  @"highWaterCount" : @(CWStatisticsLoad(&_statistics.highWaterCount)),
+			  @"waitTime" : CWStatisticsWaitHistogramDictionary(&_statistics.wait) };
+}
+
+#endif
+
+@end
@@ -0,0 +1,170 @@
+/*
+//  CWInt64QueueTests.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWInt64Queue.h"
+
+SpecBegin(CWInt64Queue)
+
+describe(@"-dequeueValue", ^{
+	it(@"should dequeue values in order", ^{
+		CWInt64Queue *queue = [CWInt64Queue new];
+		[queue enqueueValue:1];
+		[queue enqueueValue:2];
+		
+		int64_t value = 0;
+		expect([queue dequeueValue:&value]).to.beTruthy();
+		expect(value == 1).to.beTruthy();
+		[queue enqueueValue:3];
+		expect([queue dequeueValue:&value]).to.beTruthy();
+		expect(value == 2).to.beTruthy();
+		expect([queue dequeueValue:&value]).to.beTruthy();
+		expect(value == 3).to.beTruthy();
+		expect([queue dequeueValue:&value]).to.beFalsy();
+	});
+	
+	it(@"should keep its order as it wraps around & grows", ^{
+		CWInt64Queue *queue = [[CWInt64Queue alloc] initWithSynchronization:NO];
+		int64_t next = 0, expected = 0, value = 0;
+		for (NSUInteger round = 0; round < 100; round++) {
+			for (NSUInteger i = 0; i < 7; i++) [queue enqueueValue:next++];
+			for (NSUInteger i = 0; i < 5; i++) {
+				[queue dequeueValue:&value];
+				expect(value == expected++).to.beTruthy();
+			}
+		}
+		expect(queue.count == (NSUInteger)(next - expected)).to.beTruthy();
+	});
+});
+
+describe(@"-dequeueValues:maxCount:", ^{
+	it(@"should dequeue up to maxCount values", ^{
+		int64_t values[] = { 5, 6, 7 };
+		CWInt64Queue *queue = [[CWInt64Queue alloc] initWithValues:values count:3];
+		int64_t results[2] = { 0, 0 };
+		
+		expect([queue dequeueValues:results maxCount:2] == 2).to.beTruthy();
+		expect(results[0] == 5 && results[1] == 6).to.beTruthy();
+		expect([queue dequeueValues:results maxCount:2] == 1).to.beTruthy();
+		expect(results[0] == 7).to.beTruthy();
+		expect(queue.isEmpty).to.beTruthy();
+	});
+});
+
+describe(@"-containsValue", ^{
+	it(@"should correctly return when it contains a given value", ^{
+		int64_t values[] = { 1, 2, 3 };
+		CWInt64Queue *queue = [[CWInt64Queue alloc] initWithValues:values count:3];
+		
+		expect([queue containsValue:2]).to.beTruthy();
+		expect([queue containsValue:4]).to.beFalsy();
+	});
+});
+
+describe(@"-peekValue", ^{
+	it(@"should return the front value without dequeueing it", ^{
+		CWInt64Queue *queue = [CWInt64Queue new];
+		int64_t value = 0;
+		
+		expect([queue peekValue:&value]).to.beFalsy();
+		[queue enqueueValue:INT64_MIN];
+		expect([queue peekValue:&value]).to.beTruthy();
+		expect(value == INT64_MIN).to.beTruthy();
+		expect(queue.count == 1).to.beTruthy();
+	});
+});
+
+describe(@"-enumerateValuesInQueue", ^{
+	it(@"should enumerate values in order & stop when asked to", ^{
+		int64_t values[] = { 1, 2, 3, 4 };
+		CWInt64Queue *queue = [[CWInt64Queue alloc] initWithValues:values count:4];
+		__block int64_t expected = 1;
+		
+		[queue enumerateValuesInQueue:^(int64_t value, BOOL *stop) {
+			expect(value == expected).to.beTruthy();
+			if (value == 3) *stop = YES;
+			expected++;
+		}];
+		
+		expect(expected == 4).to.beTruthy();
+	});
+});
+
+describe(@"-isEqualToInt64Queue", ^{
+	it(@"should compare values in order", ^{
+		int64_t values[] = { 1, 2 };
+		CWInt64Queue *queue1 = [[CWInt64Queue alloc] initWithValues:values count:2];
+		CWInt64Queue *queue2 = [CWInt64Queue new];
+		[queue2 enqueueValue:0];
+		[queue2 enqueueValues:values count:2];
+		
+		expect([queue1 isEqualToInt64Queue:queue2]).to.beFalsy();
+		[queue2 dequeueValue:NULL];
+		expect([queue1 isEqualToInt64Queue:queue2]).to.beTruthy();
+	});
+});
+
+it(@"should serialize multithreaded access", ^{
+	CWInt64Queue *queue = [CWInt64Queue new];
+	
+	dispatch_apply(8, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+		for (int64_t value = 0; value < 1000; value++) [queue enqueueValue:value];
+	});
+	
+	expect(queue.count == 8000).to.beTruthy();
+});
+
+#if CW_STATISTICS
+
+describe(@"-statistics", ^{
+	it(@"should count operations & the high water mark", ^{
+		int64_t values[] = { 1, 2, 3 };
+		CWInt64Queue *queue = [[CWInt64Queue alloc] initWithValues:values count:3];
+		[queue enqueueValue:4];
+		int64_t value = 0;
+		[queue peekValue:&value];
+		[queue dequeueValue:&value];
+		int64_t dequeued[8];
+		[queue dequeueValues:dequeued maxCount:8];
+		[queue dequeueValue:&value];
+		
+		NSDictionary *statistics = queue.statistics;
+		expect(statistics[@"enqueueCount"]).to.equal(@1);
+		expect(statistics[@"dequeueCount"]).to.equal(@4);
+		expect(statistics[@"emptyDequeueCount"]).to.equal(@1);
+		expect(statistics[@"peekCount"]).to.equal(@1);
+		expect(statistics[@"highWaterCount"]).to.equal(@4);
+	});
+});
+
+#endif
+
+SpecEnd
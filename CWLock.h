@@ -0,0 +1,115 @@
+/*
+//  CWLock.h
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+ /*
+ This class should not make any use of the Zangetsu Framework API's so it can
+ retain its independence and be used in other projects not making use of the
+ Zangetsu Framework.
+  */
+
+#import <Foundation/Foundation.h>
+#import "CWStatistics.h"
+
+/**
+ CWLock
+ 
+ The lock the thread safe data structures embed in each instance. It is an
+ os_unfair_lock where available & a pthread mutex everywhere else. Unlike a
+ dispatch queue it costs nothing to create beyond its few bytes of storage &
+ an uncontended lock/unlock is a couple of atomic instructions.
+ 
+ Like the dispatch_sync calls it replaces the lock is not recursive, calling
+ back into a data structure from a block it is running deadlocks (or with
+ os_unfair_lock, crashes).
+ */
+
+#if __has_include(<os/lock.h>)
+
+#import <os/lock.h>
+
+typedef os_unfair_lock CWLock;
+
+static inline void CWLockInit(CWLock *lock) {
+	*lock = OS_UNFAIR_LOCK_INIT;
+}
+
+static inline void CWLockDestroy(CWLock *lock) { }
+
+static inline void CWLockLock(CWLock *lock) {
+	os_unfair_lock_lock(lock);
+}
+
+static inline void CWLockUnlock(CWLock *lock) {
+	os_unfair_lock_unlock(lock);
+}
+
+#else
+
+#include <pthread.h>
+
+typedef pthread_mutex_t CWLock;
+
+static inline void CWLockInit(CWLock *lock) {
+	pthread_mutex_init(lock, NULL);
+}
+
+static inline void CWLockDestroy(CWLock *lock) {
+	pthread_mutex_destroy(lock);
+}
+
+static inline void CWLockLock(CWLock *lock) {
+	pthread_mutex_lock(lock);
+}
+
+static inline void CWLockUnlock(CWLock *lock) {
+	pthread_mutex_unlock(lock);
+}
+
+#endif
+
+/**
+ Takes lock if synchronized is true, recording the time it took to get the lock
+ in waitHistogram when CW_STATISTICS is on
+ */
+#define CWLockAcquire(lock, synchronized, waitHistogram) \
+do { \
+	if (synchronized) { \
+		CWStatisticsWaitBegin(); \
+		CWLockLock(lock); \
+		CWStatisticsWaitEnd(waitHistogram); \
+	} \
+} while(0)
+
+#define CWLockRelease(lock, synchronized) \
+do { \
+	if (synchronized) CWLockUnlock(lock); \
+} while(0)
@@ -0,0 +1,164 @@
+/*
+//  CWPointerStack.h
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+ /*
+ This class should not make any use of the Zangetsu Framework API's so it can
+ retain its independence and be used in other projects not making use of the
+ Zangetsu Framework.
+  */
+
+#import <Foundation/Foundation.h>
+#import "CWStatistics.h"
+
+/**
+ CWPointerStack is a Thread Safe Class
+ 
+ CWPointerStack is a CWStack for raw pointers. Pointers are stored in one
+ contiguous block of memory & are never retained or released, the caller is
+ responsible for keeping whatever they point to alive while it is on the
+ stack. Use it in place of a CWStack of NSValues or wrapper objects.
+ 
+ Like CWStack it takes a lock embedded in the instance around every operation,
+ stacks only used from one thread at a time can be created with
+ -initWithSynchronization:NO to skip locking entirely.
+ */
+
+@interface CWPointerStack : NSObject
+
+/**
+ Initializes an empty stack
+ 
+ @param synchronized if YES the stack locks around every operation & is safe
+ to use from multiple threads, this is what -init does. If NO the stack does
+ no locking & must only be used from one thread at a time.
+ @return an initialized CWPointerStack object
+ */
+-(instancetype)initWithSynchronization:(BOOL)synchronized;
+
+/**
+ Returns if the stack was created with synchronization
+ */
+@property(readonly, getter=isSynchronized) BOOL synchronized;
+
+/**
+ Pushes pointer onto the stack
+ 
+ If pointer is NULL this method does nothing.
+ 
+ @param pointer the pointer to push onto the stack
+ */
+-(void)pushPointer:(void *)pointer;
+
+/**
+ Pops the pointer off the top of the stack & returns it
+ 
+ @return the pointer at the top of the stack or NULL if the stack is empty
+ */
+-(void *)popPointer;
+
+/**
+ Returns the pointer at the top of the stack without popping it
+ 
+ @return the pointer at the top of the stack or NULL if the stack is empty
+ */
+-(void *)topOfStackPointer;
+
+/**
+ Returns the pointer at the bottom of the stack
+ 
+ @return the pointer at the bottom of the stack or NULL if the stack is empty
+ */
+-(void *)bottomOfStackPointer;
+
+/**
+ Returns the pointer at index, where index 0 is the bottom of the stack
+ 
+ index must be less than the stacks count.
+ 
+ @param index the index of the pointer to return
+ @return the pointer at index
+ */
+-(void *)pointerAtIndex:(NSUInteger)index;
+
+/**
+ Removes all pointers from the stack
+ */
+-(void)clearStack;
+
+/**
+ Returns a BOOL indicating if pointer is on the stack
+ 
+ @param pointer the pointer to search for
+ @return YES if pointer is on the stack, otherwise NO
+ */
+-(BOOL)containsPointer:(void *)pointer;
+
+/**
+ Returns a BOOL indicating if stack holds the same pointers in the same order
+ 
+ @param stack the stack to compare against
+ @return YES if the stacks are equal, otherwise NO
+ */
+-(BOOL)isEqualToPointerStack:(CWPointerStack *)stack;
+
+/**
+ returns if the stack is currently empty
+ 
+ @return a BOOL indicating if the stack is empty
+ */
+-(BOOL)isEmpty;
+
+/**
+ returns a count of pointers in the current stack object
+ 
+ @return a NSUInteger indicating how many pointers are currently in the stack
+ */
+-(NSUInteger)count;
+
+#if CW_STATISTICS
+
+/**
+ Returns the statistics the stack has kept since it was created
+ 
+ The dictionary contains pushCount, popCount, emptyPopCount (calls to
+ -popPointer on an empty stack), peekCount (calls to -topOfStackPointer),
+ highWaterCount (the most pointers the stack has held at once) & waitTime, a
+ histogram of the time each call waited for the stack's lock. Only available
+ when CW_STATISTICS is set to 1.
+ 
+ @return a NSDictionary with the stack's statistics
+ */
+-(NSDictionary *)statistics;
+
+#endif
+
+@end
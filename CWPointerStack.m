@@ -0,0 +1,228 @@
+/*
+//  CWPointerStack.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWPointerStack.h"
+#import "CWAssertionMacros.h"
+#import "CWLock.h"
+
+#define kCWPointerStackMinimumCapacity 16
+
+#if CW_STATISTICS
+typedef struct CWPointerStackStatistics {
+	uint64_t pushCount;
+	uint64_t popCount;
+	uint64_t emptyPopCount;
+	uint64_t peekCount;
+	uint64_t highWaterCount;
+	CWStatisticsWaitHistogram wait;
+} CWPointerStackStatistics;
+#endif
+
+@interface CWPointerStack () {
+	CWLock _lock;
+	void **_pointers;
+	NSUInteger _capacity;
+	NSUInteger _count;
+#if CW_STATISTICS
+	CWPointerStackStatistics _statistics;
+#endif
+}
+@end
+
+#define CWPointerStackLock() CWLockAcquire(&_lock, _synchronized, _statistics.wait)
+#define CWPointerStackUnlock() CWLockRelease(&_lock, _synchronized)
+
+@implementation CWPointerStack
+
+-(instancetype)init {
+	return [self initWithSynchronization:YES];
+}
+
+-(instancetype)initWithSynchronization:(BOOL)synchronized {
+	self = [super init];
+	if (self == nil) return nil;
+	
+	//storage is allocated by the first push
+	_pointers = NULL;
+	_capacity = 0;
+	_count = 0;
+	_synchronized = synchronized;
+	CWLockInit(&_lock);
+	
+	return self;
+}
+
+-(void)dealloc {
+	free(_pointers);
+	CWLockDestroy(&_lock);
+}
+
+-(void)pushPointer:(void *)pointer {
+	if (pointer == NULL) return;
+	
+	CWPointerStackLock();
+	if (_count == _capacity) {
+		NSUInteger capacity = MAX(_capacity * 2, (NSUInteger)kCWPointerStackMinimumCapacity);
+		void **pointers = realloc(_pointers, capacity * sizeof(void *));
+		CWAssert(pointers != NULL);
+		_pointers = pointers;
+		_capacity = capacity;
+	}
+	_pointers[_count++] = pointer;
+	CWStatisticsCount(_statistics.pushCount);
+	CWStatisticsHighWater(_statistics.highWaterCount, _count);
+	CWPointerStackUnlock();
+}
+
+-(void *)popPointer {
+	void *pointer = NULL;
+	CWPointerStackLock();
+	if (_count > 0) {
+		pointer = _pointers[--_count];
+		CWStatisticsCount(_statistics.popCount);
+	} else {
+		CWStatisticsCount(_statistics.emptyPopCount);
+	}
+	CWPointerStackUnlock();
+	return pointer;
+}
+
+-(void *)topOfStackPointer {
+	void *pointer = NULL;
+	CWPointerStackLock();
+	CWStatisticsCount(_statistics.peekCount);
+	if (_count > 0) pointer = _pointers[_count - 1];
+	CWPointerStackUnlock();
+	return pointer;
+}
+
+-(void *)bottomOfStackPointer {
+	void *pointer = NULL;
+	CWPointerStackLock();
+	if (_count > 0) pointer = _pointers[0];
+	CWPointerStackUnlock();
+	return pointer;
+}
+
+-(void *)pointerAtIndex:(NSUInteger)index {
+	CWPointerStackLock();
+	CWAssert(index < _count);
+	void *pointer = _pointers[index];
+	CWPointerStackUnlock();
+	return pointer;
+}
+
+-(void)clearStack {
+	CWPointerStackLock();
+	_count = 0;
+	CWPointerStackUnlock();
+}
+
+-(BOOL)containsPointer:(void *)pointer {
+	BOOL contains = NO;
+	CWPointerStackLock();
+	for (NSUInteger i = 0; i < _count; i++) {
+		if (_pointers[i] == pointer) {
+			contains = YES;
+			break;
+		}
+	}
+	CWPointerStackUnlock();
+	return contains;
+}
+
+/**
+ Returns a malloc'd copy of the pointers from the bottom of the stack up which
+ the caller must free
+ */
+-(void **)_copyPointersWithCount:(NSUInteger *)count {
+	CWPointerStackLock();
+	void **copy = malloc(MAX(_count, (NSUInteger)1) * sizeof(void *));
+	CWAssert(copy != NULL);
+	if (_count > 0) memcpy(copy, _pointers, _count * sizeof(void *));
+	*count = _count;
+	CWPointerStackUnlock();
+	return copy;
+}
+
+-(BOOL)isEqualToPointerStack:(CWPointerStack *)stack {
+	if (stack == self) return YES;
+	if (stack == nil) return NO;
+	
+	//copy the other stack first so we never hold both locks at once
+	NSUInteger otherCount = 0;
+	void **otherPointers = [stack _copyPointersWithCount:&otherCount];
+	
+	CWPointerStackLock();
+	BOOL isEqual = (otherCount == _count) &&
+		((_count == 0) || (memcmp(_pointers, otherPointers, _count * sizeof(void *)) == 0));
+	CWPointerStackUnlock();
+	free(otherPointers);
+	return isEqual;
+}
+
+-(BOOL)isEmpty {
+	return (self.count == 0);
+}
+
+-(NSUInteger)count {
+	CWPointerStackLock();
+	NSUInteger count = _count;
+	CWPointerStackUnlock();
+	return count;
+}
+
+-(NSString *)description {
+	NSUInteger count = 0;
+	void **pointers = [self _copyPointersWithCount:&count];
+	NSMutableArray *values = [NSMutableArray arrayWithCapacity:count];
+	for (NSUInteger i = 0; i < count; i++) [values addObject:[NSValue valueWithPointer:pointers[i]]];
+	free(pointers);
+	return [values description];
+}
+
+#if CW_STATISTICS
+
+#pragma mark Statistics -
+
+-(NSDictionary *)statistics {
+	return @{ @"pushCount" : @(CWStatisticsLoad(&_statistics.pushCount)),
+			  @"popCount" : @(CWStatisticsLoad(&_statistics.popCount)),
+			  @"emptyPopCount" : @(CWStatisticsLoad(&_statistics.emptyPopCount)),
+			  @"peekCount" : @(CWStatisticsLoad(&_statistics.peekCount)),
+			  @"highWaterCount" : @(CWStatisticsLoad(&_statistics.highWaterCount)),
+			  @"waitTime" : CWStatisticsWaitHistogramDictionary(&_statistics.wait) };
+}
+
+#endif
+
+@end
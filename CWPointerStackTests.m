@@ -0,0 +1,136 @@
+/*
+//  CWPointerStackTests.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWPointerStack.h"
+
+SpecBegin(CWPointerStack)
+
+static int a = 1, b = 2, c = 3;
+
+describe(@"-popPointer", ^{
+	it(@"should pop pointers in reverse order", ^{
+		CWPointerStack *stack = [CWPointerStack new];
+		[stack pushPointer:&a];
+		[stack pushPointer:&b];
+		[stack pushPointer:&c];
+		
+		expect([stack popPointer] == &c).to.beTruthy();
+		expect([stack popPointer] == &b).to.beTruthy();
+		expect([stack popPointer] == &a).to.beTruthy();
+		expect([stack popPointer] == NULL).to.beTruthy();
+	});
+	
+	it(@"should not push NULL", ^{
+		CWPointerStack *stack = [CWPointerStack new];
+		[stack pushPointer:NULL];
+		
+		expect(stack.isEmpty).to.beTruthy();
+	});
+});
+
+describe(@"-topOfStackPointer & -bottomOfStackPointer", ^{
+	it(@"should return the ends of the stack without popping", ^{
+		CWPointerStack *stack = [[CWPointerStack alloc] initWithSynchronization:NO];
+		
+		expect([stack topOfStackPointer] == NULL).to.beTruthy();
+		[stack pushPointer:&a];
+		[stack pushPointer:&b];
+		
+		expect([stack topOfStackPointer] == &b).to.beTruthy();
+		expect([stack bottomOfStackPointer] == &a).to.beTruthy();
+		expect([stack pointerAtIndex:1] == &b).to.beTruthy();
+		expect(stack.count == 2).to.beTruthy();
+	});
+});
+
+describe(@"-containsPointer", ^{
+	it(@"should find pointers on the stack", ^{
+		CWPointerStack *stack = [CWPointerStack new];
+		[stack pushPointer:&a];
+		
+		expect([stack containsPointer:&a]).to.beTruthy();
+		expect([stack containsPointer:&b]).to.beFalsy();
+		[stack clearStack];
+		expect([stack containsPointer:&a]).to.beFalsy();
+	});
+});
+
+describe(@"-isEqualToPointerStack", ^{
+	it(@"should compare pointers in order", ^{
+		CWPointerStack *stack1 = [CWPointerStack new];
+		CWPointerStack *stack2 = [CWPointerStack new];
+		[stack1 pushPointer:&a];
+		[stack1 pushPointer:&b];
+		[stack2 pushPointer:&b];
+		[stack2 pushPointer:&a];
+		
+		expect([stack1 isEqualToPointerStack:stack2]).to.beFalsy();
+		[stack2 clearStack];
+		[stack2 pushPointer:&a];
+		[stack2 pushPointer:&b];
+		expect([stack1 isEqualToPointerStack:stack2]).to.beTruthy();
+	});
+});
+
+it(@"should be able to grow past its initial capacity", ^{
+	CWPointerStack *stack = [CWPointerStack new];
+	for (NSUInteger i = 0; i < 1000; i++) [stack pushPointer:(i % 2) ? &a : &b];
+	
+	expect(stack.count == 1000).to.beTruthy();
+	expect([stack pointerAtIndex:999] == &a).to.beTruthy();
+});
+
+#if CW_STATISTICS
+
+describe(@"-statistics", ^{
+	it(@"should count operations & the high water mark", ^{
+		int a = 0, b = 0;
+		CWPointerStack *stack = [CWPointerStack new];
+		[stack pushPointer:&a];
+		[stack pushPointer:&b];
+		[stack topOfStackPointer];
+		[stack popPointer];
+		[stack popPointer];
+		[stack popPointer];
+		
+		NSDictionary *statistics = stack.statistics;
+		expect(statistics[@"pushCount"]).to.equal(@2);
+		expect(statistics[@"popCount"]).to.equal(@2);
+		expect(statistics[@"emptyPopCount"]).to.equal(@1);
+		expect(statistics[@"peekCount"]).to.equal(@1);
+		expect(statistics[@"highWaterCount"]).to.equal(@2);
+	});
+});
+
+#endif
+
+SpecEnd
@@ -41,6 +41,7 @@
 #define kCWPriorityMin NSUIntegerMax
 
 #import <Foundation/Foundation.h>
+#import "CWStatistics.h"
 
 @interface CWPriorityQueue : NSObject
 
@@ -115,4 +116,20 @@
  */
 -(NSUInteger)countofObjectsWithPriority:(NSUInteger)priority;
 
+#if CW_STATISTICS
+
+/**
+ Returns the statistics the queue has kept since it was created
+ 
+ The dictionary contains addCount, dequeueCount (including objects removed by
+ -dequeueAllObjectsOfNextPriorityLevel), emptyDequeueCount (calls to -dequeue
+ on an empty queue), peekCount & highWaterCount (the most objects the queue
+ has held at once). Only available when CW_STATISTICS is set to 1.
+ 
+ @return a NSDictionary with the queue's statistics
+ */
+-(NSDictionary *)statistics;
+
+#endif
+
 @end
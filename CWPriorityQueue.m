@@ -75,7 +75,21 @@ do { \
 
 @end
 
-@interface CWPriorityQueue ()
+#if CW_STATISTICS
+typedef struct CWPriorityQueueStatistics {
+	uint64_t addCount;
+	uint64_t dequeueCount;
+	uint64_t emptyDequeueCount;
+	uint64_t peekCount;
+	uint64_t highWaterCount;
+} CWPriorityQueueStatistics;
+#endif
+
+@interface CWPriorityQueue () {
+#if CW_STATISTICS
+	CWPriorityQueueStatistics _statistics;
+#endif
+}
 @property(strong) NSMutableArray *storage;
 @end
 
@@ -115,6 +129,8 @@ do { \
 	CWPriorityQueueItem *container = [CWPriorityQueueItem itemWithObject:item
 															 andPriority:priority];
 	[self.storage addObject:container];
+	CWStatisticsCount(_statistics.addCount);
+	CWStatisticsHighWater(_statistics.highWaterCount, self.storage.count);
 	[self _sortStorage];
 }
 
@@ -127,11 +143,16 @@ do { \
 }
 
 -(id)peek {
+	CWStatisticsCount(_statistics.peekCount);
 	return ((CWPriorityQueueItem *)((self.storage.count > 0) ? self.storage[0] : nil)).item;
 }
 
 -(id)dequeue {
-	if(self.storage.count == 0) return nil;
+	if(self.storage.count == 0) {
+		CWStatisticsCount(_statistics.emptyDequeueCount);
+		return nil;
+	}
+	CWStatisticsCount(_statistics.dequeueCount);
 	id obj = ((CWPriorityQueueItem *)self.storage[0]).item;
 	[self.storage removeObjectAtIndex:0];
 	return obj;
@@ -142,6 +163,7 @@ do { \
 	NSUInteger priorityLevel = ((CWPriorityQueueItem *)self.storage[0]).priority;
 	NSArray *priorityResults = [self _arrayOfAllObjectsOfPriority:priorityLevel];
 	[self.storage removeObjectsInArray:priorityResults];
+	CWStatisticsAdd(_statistics.dequeueCount, priorityResults.count);
 	//extract the items so we don't return CWPriorityQueueItems...
 	NSMutableArray *results = [NSMutableArray array];
 	[priorityResults enumerateObjectsUsingBlock:^(id obj, NSUInteger idx, BOOL *stop) {
@@ -177,4 +199,18 @@ do { \
 	return set.count;
 }
 
+#if CW_STATISTICS
+
+#pragma mark Statistics -
+
+-(NSDictionary *)statistics {
+	return @{ @"addCount" : @(CWStatisticsLoad(&_statistics.addCount)),
+			  @"dequeueCount" : @(CWStatisticsLoad(&_statistics.dequeueCount)),
+			  @"emptyDequeueCount" : @(CWStatisticsLoad(&_statistics.emptyDequeueCount)),
+			  @"peekCount" : @(CWStatisticsLoad(&_statistics.peekCount)),
+			  @"highWaterCount" : @(CWStatisticsLoad(&_statistics.highWaterCount)) };
+}
+
+#endif
+
 @end
@@ -166,4 +166,26 @@ it(@"should return the correct total of all objects in the queue", ^{
     expect(queue.count == 0).to.beTruthy();
 });
 
+#if CW_STATISTICS
+
+it(@"should keep statistics", ^{
+    CWPriorityQueue *queue = [CWPriorityQueue new];
+    [queue addItem:@"Hello" withPriority:3];
+    [queue addItem:@"World" withPriority:5];
+    [queue addItem:@"!" withPriority:5];
+    [queue peek];
+    [queue dequeue];
+    [queue dequeueAllObjectsOfNextPriorityLevel];
+    [queue dequeue];
+    
+    NSDictionary *statistics = queue.statistics;
+    expect(statistics[@"addCount"]).to.equal(@3);
+    expect(statistics[@"dequeueCount"]).to.equal(@3);
+    expect(statistics[@"emptyDequeueCount"]).to.equal(@1);
+    expect(statistics[@"peekCount"]).to.equal(@1);
+    expect(statistics[@"highWaterCount"]).to.equal(@3);
+});
+
+#endif
+
 SpecEnd
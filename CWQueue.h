@@ -39,16 +39,97 @@
 
  
 #import <Foundation/Foundation.h>
+#import "CWStatistics.h"
+#import "CWQueueSegmentLog.h"
 
 /**
  CWQueue is a Thread Safe Class
 
- Internally CWQueue uses a dispatch_queue_t queue to perform all operations
- on and to ensure that all operations to a given queue instance are 
- executed serially.
+ Internally CWQueue takes a lock around all operations to ensure that all
+ operations to a given queue instance are executed serially. The lock is
+ embedded in the instance so creating a queue costs little more than creating
+ its storage. Queues that are only ever used from one thread at a time can be
+ created with -initWithSynchronization:NO to skip locking entirely.
+ 
+ A queue created with -initWithDirectory:syncPolicy:error: is durable, its
+ objects are kept in a CWQueueSegmentLog in that directory & are still there
+ when the queue is created again with the same directory after the process
+ restarts.
+ */
+
+@interface CWQueue : NSObject <NSFastEnumeration>
+
+/**
+ Initializes an empty CWQueue object
+ 
+ @param synchronized if YES the queue locks around every operation & is safe
+ to use from multiple threads, this is what -init does. If NO the queue does
+ no locking & must only be used from one thread at a time.
+ @return an initialized CWQueue object
+ */
+-(instancetype)initWithSynchronization:(BOOL)synchronized;
+
+/**
+ Returns if the queue was created with synchronization
+ */
+@property(readonly, getter=isSynchronized) BOOL synchronized;
+
+/**
+ Initializes a durable CWQueue backed by a segment log in directory
+ 
+ Every enqueued object is appended to the log & every dequeue moves the logs
+ checkpointed head, so when a queue is created again with the same directory
+ it has every object that was enqueued & not dequeued. Only the end of the log
+ is scanned when it is opened so recovering a big backlog is fast, the backlog
+ is read from the log as it is dequeued rather than loaded up front. While the
+ queue is running the most recently enqueued objects are also kept in memory &
+ dequeued from there without touching the log.
+ 
+ Objects must be NSData, NSString or conform to NSCoding. Objects read back
+ from the log (after a restart or once the queue is too long to keep them all
+ in memory) are equal copies of the objects that were enqueued.
+ 
+ With CWQueueSyncPolicyEveryWrite -enqueue: returns once the object is on disk,
+ concurrent enqueues share syncs. Dequeues never wait for a sync, the head is
+ synced with the next sync so after a power loss the last few objects dequeued
+ may be dequeued again. Durable queues are always synchronized.
+ 
+ @param directory the directory the queues log is kept in
+ @param syncPolicy how enqueued objects get onto disk
+ @param error if the log can't be opened this is set to an error describing why
+ @return an initialized durable CWQueue or nil if the log couldn't be opened
  */
+-(instancetype)initWithDirectory:(NSString *)directory
+					  syncPolicy:(CWQueueSyncPolicy)syncPolicy
+						   error:(NSError **)error;
 
-@interface CWQueue : NSObject
+/**
+ Returns if the queue is backed by a segment log
+ */
+@property(readonly, getter=isDurable) BOOL durable;
+
+/**
+ Waits until every object enqueued so far & the current head are on disk
+ 
+ Does nothing for queues that aren't durable.
+ */
+-(void)sync;
+
+/**
+ The number of objects a durable queue has lost since it was created
+ 
+ Objects are lost when their records in the log are damaged or missing, or
+ can't be decoded (e.g. the class of an archived object no longer exists).
+ The queue skips them rather than stopping on them. Always 0 for queues that
+ aren't durable.
+ */
+@property(readonly) uint64_t discardedObjectCount;
+
+/**
+ An error describing the last time a durable queue lost objects or found a
+ problem with its log when it was opened, nil if there has been none
+ */
+@property(readonly) NSError *lastError;
 
 /**
  Initializes a CWQueue object with the contents of array
@@ -66,23 +147,54 @@
  Adds a object to the receiving objects queue
  
  Adds object to the receiving CWQueues internal storage. If the object is
- nil then this method simply does nothing.
+ nil then this method simply does nothing. If a durable queue can't add the
+ object to its log this raises NSInternalInconsistencyException, use
+ -enqueue:error: to handle that instead.
  
- @param object added to the end of the queue. If nil an assertion is thrown.
+ @param object added to the end of the queue
  */
 -(void)enqueue:(id)object;
 
+/**
+ Adds a object to the receiving queue, reporting why if it can't
+ 
+ Only durable queues can fail to enqueue, when their log can't start a new
+ segment file (for example when the disk is full).
+ 
+ @param object added to the end of the queue, if nil nothing is added
+ @param error if the object couldn't be added this is set to an error
+ describing why
+ @return YES if the object was added (or was nil), NO if it wasn't
+ */
+-(BOOL)enqueue:(id)object error:(NSError **)error;
+
 /**
  Adds the objects from the objects array to the receiving queue
  
  This takes the objects in order they are in the objects array and appends them
  onto the receiving queues storage. If the object array is empty(0 objects) or
- nil then this method simply does nothing.
+ nil then this method simply does nothing. If a durable queue can't add the
+ objects to its log this raises NSInternalInconsistencyException, use
+ -enqueueObjectsFromArray:error: to handle that instead.
  
  @param a NSArray of objects to be appended onto the receiving queues storage
  */
 -(void)enqueueObjectsFromArray:(NSArray *)objects;
 
+/**
+ Adds the objects from the objects array to the receiving queue, all of them or
+ none of them
+ 
+ A durable queue creates every segment file the objects need before writing
+ any of them to its log, so if it can't add them all it adds none.
+ 
+ @param objects a NSArray of objects to be appended onto the receiving queue
+ @param error if the objects couldn't be added this is set to an error
+ describing why
+ @return YES if every object was added, NO if none were
+ */
+-(BOOL)enqueueObjectsFromArray:(NSArray *)objects error:(NSError **)error;
+
 /**
  Removes all objects from the receiving queues storage
  */
@@ -129,10 +241,32 @@
  
  Enumerates over the receiving queues objects in order. Each time the block is 
  called it gives you a reference to the object in the queue currently being
- enumerated over.
+ enumerated over. A durable queue decodes the objects that are only in its log
+ one at a time as the enumeration reaches them, so stopping early never decodes
+ the rest of the backlog. The queue is locked while the block runs.
  */
 -(void)enumerateObjectsInQueue:(void(^)(id object, BOOL *stop))block;
 
+/**
+ Fast enumeration over the queue, lets you use for...in on a CWQueue
+ 
+ Objects are given out in the order they would be dequeued. For a synchronized
+ queue the loop goes over a snapshot of the queue taken when the loop starts,
+ the loop body is free to enqueue & dequeue on the queue (from any thread) and
+ that won't change what the loop sees. For an unsynchronized queue the loop
+ goes directly over the queues storage and mutating the queue during the loop
+ raises an exception, just like mutating a NSMutableArray during a for...in.
+ 
+ For a durable queue the snapshot holds every queued object, so the first pass
+ of the loop decodes the whole backlog from the log & keeps it in memory until
+ the loop ends. For big backlogs use -enumerateObjectsInQueue:, or
+ -containsObject: & -containsObjectWithBlock: which stop decoding once they
+ find a match.
+ */
+-(NSUInteger)countByEnumeratingWithState:(NSFastEnumerationState *)state
+								 objects:(id __unsafe_unretained [])buffer
+								   count:(NSUInteger)len;
+
 /**
  Allows you to view the head object without dequeueing it
  
@@ -186,4 +320,20 @@
  */
 -(BOOL)isEqualToQueue:(CWQueue *)aQueue;
 
+#if CW_STATISTICS
+
+/**
+ Returns the statistics the queue has kept since it was created
+ 
+ The dictionary contains enqueueCount, dequeueCount, emptyDequeueCount (calls
+ to -dequeue on an empty queue), peekCount, highWaterCount (the most objects
+ the queue has held at once) & waitTime, a histogram of the time each call
+ waited for the queue's lock. Only available when CW_STATISTICS is set to 1.
+ 
+ @return a NSDictionary with the queue's statistics
+ */
+-(NSDictionary *)statistics;
+
+#endif
+
 @end
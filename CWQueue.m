@@ -32,25 +32,105 @@
  */
  
 #import "CWQueue.h"
-#import <libkern/OSAtomic.h>
+#import "CWLock.h"
 
-@interface CWQueue()
+//durable queues keep at most this many of the newest objects in memory, the
+//rest are read back from the log when they are dequeued
+#define kCWQueueDurableMemoryLimit 16384
+
+//the types of log records, how an object was encoded
+#define kCWQueueRecordData 1
+#define kCWQueueRecordString 2
+#define kCWQueueRecordArchive 3
+
+#if CW_STATISTICS
+typedef struct CWQueueStatistics {
+	uint64_t enqueueCount;
+	uint64_t dequeueCount;
+	uint64_t emptyDequeueCount;
+	uint64_t peekCount;
+	uint64_t highWaterCount;
+	CWStatisticsWaitHistogram wait;
+} CWQueueStatistics;
+#endif
+
+@interface CWQueue() {
+	CWLock _lock;
+	CWQueueSegmentLog *_log;
+	//the log sequence of dataStore[0] for durable queues, dataStore holds
+	//the objects from here to the logs tail
+	uint64_t _memorySequence;
+#if CW_STATISTICS
+	CWQueueStatistics _statistics;
+#endif
+}
 //private internal ivar
 @property(nonatomic, strong) NSMutableArray *dataStore;
-@property(nonatomic) dispatch_queue_t queue;
 @end
 
-static int64_t queueCounter = 0;
+#define CWQueueLock() CWLockAcquire(&_lock, _synchronized, _statistics.wait)
+#define CWQueueUnlock() CWLockRelease(&_lock, _synchronized)
+
+static NSError *CWQueueCodingError(NSInteger code, NSString *description) {
+	return [NSError errorWithDomain:NSCocoaErrorDomain
+							   code:code
+						   userInfo:@{ NSLocalizedDescriptionKey : description }];
+}
+
+static NSData *CWQueueEncodeObject(id object, uint8_t *type, NSError **error) {
+	if ([object isKindOfClass:[NSData class]]) {
+		*type = kCWQueueRecordData;
+		return object;
+	}
+	if ([object isKindOfClass:[NSString class]]) {
+		*type = kCWQueueRecordString;
+		NSData *data = [(NSString *)object dataUsingEncoding:NSUTF8StringEncoding];
+		if (data == nil && error) *error = CWQueueCodingError(NSCoderInvalidValueError, @"A string could not be encoded as UTF-8");
+		return data;
+	}
+	*type = kCWQueueRecordArchive;
+	//objects only have to conform to NSCoding, not NSSecureCoding
+	return [NSKeyedArchiver archivedDataWithRootObject:object requiringSecureCoding:NO error:error];
+}
+
+/**
+ Decodes a log record back into an object, returns nil & sets error if the
+ record can't be decoded
+ */
+static id CWQueueDecodeRecord(const void *bytes, NSUInteger length, uint8_t type, NSError **error) {
+	switch (type) {
+		case kCWQueueRecordData:
+			return [NSData dataWithBytes:bytes length:length];
+		case kCWQueueRecordString: {
+			NSString *string = [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+			if (string == nil && error) *error = CWQueueCodingError(NSCoderReadCorruptError, @"A queued string is not valid UTF-8");
+			return string;
+		}
+		case kCWQueueRecordArchive: {
+			NSData *data = [NSData dataWithBytesNoCopy:(void *)bytes length:length freeWhenDone:NO];
+			NSKeyedUnarchiver *unarchiver = [[NSKeyedUnarchiver alloc] initForReadingFromData:data error:error];
+			if (unarchiver == nil) return nil;
+			unarchiver.requiresSecureCoding = NO;
+			NSError *decodeError = nil;
+			id object = [unarchiver decodeTopLevelObjectForKey:NSKeyedArchiveRootObjectKey error:&decodeError];
+			[unarchiver finishDecoding];
+			if (object == nil && error) {
+				*error = decodeError ?: CWQueueCodingError(NSCoderValueNotFoundError, @"A queued archive has no root object");
+			}
+			return object;
+		}
+		default:
+			if (error) *error = CWQueueCodingError(NSCoderReadCorruptError, [NSString stringWithFormat:@"A queued record has an unknown type %u", type]);
+			return nil;
+	}
+}
 
 @implementation CWQueue
 
 /**
- Note on the usage of dispatch_barrier_sync(_storageQueue, ^{ });
- these are synchronization points. Anytime a "batch operation" ie
- a method that alters more than 1 object in the queue appears then
- these are needed to ensure that all operations before that point
- complete and any ones at the end of the method ensure that all
- operations enqueued complete before going on.
+ Note on synchronization: every method that touches dataStore does so while
+ holding _lock, unless the queue was created unsynchronized in which case it
+ is up to the owner to only use it from one thread at a time.
  */
 
 #pragma mark Initiailziation -
@@ -64,124 +144,329 @@ static int64_t queueCounter = 0;
  @return a CWQueue object ready to accept objects to be added to it.
  */
 -(instancetype)init {
+	return [self initWithSynchronization:YES];
+}
+
+-(instancetype)initWithSynchronization:(BOOL)synchronized {
 	self = [super init];
 	if (self == nil) return nil;
 	
 	_dataStore = [NSMutableArray array];
-	const char *label = [[NSString stringWithFormat:@"com.Zangetsu.CWStack_%lli",
-						  OSAtomicIncrement64(&queueCounter)] UTF8String];
-	_queue = dispatch_queue_create(label, DISPATCH_QUEUE_SERIAL);
+	_synchronized = synchronized;
+	CWLockInit(&_lock);
 	
 	return self;
 }
 
 -(instancetype)initWithObjectsFromArray:(NSArray *)array {
-	self = [super init];
+	self = [self initWithSynchronization:YES];
+	if (self == nil) return nil;
+	
+	if (array.count > 0) [_dataStore addObjectsFromArray:array];
+	CWStatisticsHighWater(_statistics.highWaterCount, _dataStore.count);
+	
+	return self;
+}
+
+-(instancetype)initWithDirectory:(NSString *)directory
+					  syncPolicy:(CWQueueSyncPolicy)syncPolicy
+						   error:(NSError **)error {
+	self = [self initWithSynchronization:YES];
 	if (self == nil) return nil;
 	
-	_dataStore = [NSMutableArray arrayWithArray:array];
-	const char *label = [[NSString stringWithFormat:@"com.Zangetsu.CWStack_%lli",
-						  OSAtomicIncrement64(&queueCounter)] UTF8String];
-	_queue = dispatch_queue_create(label, DISPATCH_QUEUE_SERIAL);
+	_log = [[CWQueueSegmentLog alloc] initWithDirectory:directory
+											segmentSize:kCWQueueSegmentLogDefaultSegmentSize
+											 syncPolicy:syncPolicy
+												  error:error];
+	if (_log == nil) return nil;
+	//the recovered backlog stays in the log until it is dequeued
+	_memorySequence = _log.tailSequence;
 	
 	return self;
 }
 
+-(void)dealloc {
+	CWLockDestroy(&_lock);
+}
+
+#pragma mark Durability -
+
+-(BOOL)isDurable {
+	return (_log != nil);
+}
+
+-(void)sync {
+	[_log sync];
+}
+
+/**
+ Appends objects to the log & to the in memory objects, all of them or none.
+ Objects are encoded before taking the lock so encoding doesn't hold up other
+ threads.
+ */
+-(BOOL)_enqueueDurableObjects:(NSArray *)objects error:(NSError **)error {
+	NSUInteger count = objects.count;
+	NSMutableArray *records = [NSMutableArray arrayWithCapacity:count];
+	uint8_t *types = malloc(count);
+	CWAssert(types != NULL);
+	for (NSUInteger i = 0; i < count; i++) {
+		NSData *record = CWQueueEncodeObject(objects[i], &types[i], error);
+		if (record == nil) {
+			free(types);
+			return NO;
+		}
+		[records addObject:record];
+	}
+	
+	uint64_t sequence = 0;
+	CWQueueLock();
+	BOOL appended = [_log appendRecords:records types:types lastSequence:&sequence error:error];
+	if (appended) {
+		[self.dataStore addObjectsFromArray:objects];
+		CWStatisticsAdd(_statistics.enqueueCount, count);
+		NSUInteger overLimit = (self.dataStore.count > kCWQueueDurableMemoryLimit) ? (self.dataStore.count - kCWQueueDurableMemoryLimit) : 0;
+		if (overLimit > 0) {
+			[self.dataStore removeObjectsInRange:NSMakeRange(0, overLimit)];
+			_memorySequence += overLimit;
+		}
+		CWStatisticsHighWater(_statistics.highWaterCount, _log.count);
+	}
+	CWQueueUnlock();
+	free(types);
+	
+	if (appended && _log.syncPolicy == CWQueueSyncPolicyEveryWrite) [_log syncThroughSequence:sequence + 1];
+	return appended;
+}
+
+/**
+ Returns the object at the head of a durable queue, from memory if it is there
+ or else decoded from the log. Records that can't be decoded are discarded from
+ the log so they can't stop the queue. Must be called with the lock held.
+ */
+-(id)_durableHeadObject {
+	while (YES) {
+		[self _removeObjectsDiscardedFromLog];
+		if (_log.headSequence >= _memorySequence) return self.dataStore.firstObject;
+		
+		__block id object = nil;
+		__block NSError *error = nil;
+		[_log readHeadRecordUsingBlock:^(const void *bytes, NSUInteger length, uint8_t type) {
+			NSError *decodeError = nil;
+			object = CWQueueDecodeRecord(bytes, length, type, &decodeError);
+			error = decodeError;
+		}];
+		if (object) return object;
+		//either the log discarded everything up to the in memory objects or
+		//the head record can't be decoded
+		if (_log.headSequence < _memorySequence) [_log discardHeadRecordForReason:error];
+	}
+}
+
+/**
+ Removes the object at the head of a durable queue, must be called with the
+ lock held
+ */
+-(void)_removeDurableHeadObject {
+	if (_log.headSequence >= _memorySequence) {
+		[self.dataStore removeObjectAtIndex:0];
+		_memorySequence++;
+	}
+	[_log advanceHead];
+	[self _removeObjectsDiscardedFromLog];
+}
+
+/**
+ The log discards records it finds damaged, drops the in memory copies of any
+ of those so dataStore still holds the objects from _memorySequence to the
+ logs tail. Must be called with the lock held.
+ */
+-(void)_removeObjectsDiscardedFromLog {
+	uint64_t headSequence = _log.headSequence;
+	if (headSequence <= _memorySequence) return;
+	[self.dataStore removeObjectsInRange:NSMakeRange(0, (NSUInteger)(headSequence - _memorySequence))];
+	_memorySequence = headSequence;
+}
+
+-(uint64_t)discardedObjectCount {
+	CWQueueLock();
+	uint64_t discarded = _log.discardedRecordCount;
+	CWQueueUnlock();
+	return discarded;
+}
+
+-(NSError *)lastError {
+	CWQueueLock();
+	NSError *error = _log.lastError;
+	CWQueueUnlock();
+	return error;
+}
+
+/**
+ Calls block with every object in the queue in order, stopping early if block
+ sets stop. For a durable queue the objects that are only in the log are decoded
+ one at a time as they are reached, so a search that stops early never decodes
+ the rest of the backlog. Must be called with the lock held.
+ */
+-(void)_enumerateQueuedObjectsUsingBlock:(void (^)(id object, BOOL *stop))block {
+	__block BOOL stop = NO;
+	if (_log != nil && _log.headSequence < _memorySequence) {
+		[_log enumerateRecordsBeforeSequence:_memorySequence
+								  usingBlock:^(const void *bytes, NSUInteger length, uint8_t type, BOOL *stopRecords) {
+			@autoreleasepool {
+				//records that can't be decoded are skipped, as -dequeue would
+				id object = CWQueueDecodeRecord(bytes, length, type, NULL);
+				if (object) block(object, &stop);
+			}
+			*stopRecords = stop;
+		}];
+	}
+	for (id object in self.dataStore) {
+		if (stop) break;
+		block(object, &stop);
+	}
+}
+
+/**
+ Returns every object in the queue in order. For a durable queue the objects
+ that are only in the log are decoded, otherwise this is dataStore itself. Must
+ be called with the lock held.
+ */
+-(NSArray *)_queuedObjects {
+	if (_log == nil) return self.dataStore;
+	
+	NSMutableArray *objects = [NSMutableArray arrayWithCapacity:_log.count];
+	[self _enumerateQueuedObjectsUsingBlock:^(id object, BOOL *stop) {
+		[objects addObject:object];
+	}];
+	return objects;
+}
+
 #pragma mark Add & Remove Objects -
 
 -(id)dequeue {
-	__block id object = nil;
-	__typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		if (sself.dataStore.count == 0) return;
-		object = sself.dataStore[0];
-		[sself.dataStore removeObjectAtIndex:0];
-	});
+	id object = nil;
+	CWQueueLock();
+	if (_log) {
+		object = [self _durableHeadObject];
+		if (object) {
+			[self _removeDurableHeadObject];
+			CWStatisticsCount(_statistics.dequeueCount);
+		} else {
+			CWStatisticsCount(_statistics.emptyDequeueCount);
+		}
+	} else if (self.dataStore.count == 0) {
+		CWStatisticsCount(_statistics.emptyDequeueCount);
+	} else {
+		CWStatisticsCount(_statistics.dequeueCount);
+		object = self.dataStore[0];
+		[self.dataStore removeObjectAtIndex:0];
+	}
+	CWQueueUnlock();
 	return object;
 }
 
 -(void)enqueue:(id)object {
 	if (object == nil) return;
+	NSError *error = nil;
+	if (![self enqueue:object error:&error]) {
+		[NSException raise:NSInternalInconsistencyException
+					format:@"CWQueue could not enqueue %@: %@", object, error.localizedDescription];
+	}
+}
+
+-(BOOL)enqueue:(id)object error:(NSError **)error {
+	if (object == nil) return YES;
+	if (_log) return [self _enqueueDurableObjects:@[ object ] error:error];
 
-	__typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		[sself.dataStore addObject:object];
-	});
+	CWQueueLock();
+	[self.dataStore addObject:object];
+	CWStatisticsCount(_statistics.enqueueCount);
+	CWStatisticsHighWater(_statistics.highWaterCount, self.dataStore.count);
+	CWQueueUnlock();
+	return YES;
 }
 
 -(void)enqueueObjectsFromArray:(NSArray *)objects {
-	if(objects.count == 0) return;
+	NSError *error = nil;
+	if (![self enqueueObjectsFromArray:objects error:&error]) {
+		[NSException raise:NSInternalInconsistencyException
+					format:@"CWQueue could not enqueue %lu objects: %@", (unsigned long)objects.count, error.localizedDescription];
+	}
+}
+
+-(BOOL)enqueueObjectsFromArray:(NSArray *)objects error:(NSError **)error {
+	if(objects.count == 0) return YES;
+	if (_log) return [self _enqueueDurableObjects:objects error:error];
 
-	__typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		[sself.dataStore addObjectsFromArray:objects];
-	});
+	CWQueueLock();
+	[self.dataStore addObjectsFromArray:objects];
+	CWStatisticsAdd(_statistics.enqueueCount, objects.count);
+	CWStatisticsHighWater(_statistics.highWaterCount, self.dataStore.count);
+	CWQueueUnlock();
+	return YES;
 }
 
 -(void)removeAllObjects {
-	__typeof(self) __weak wself = self;
-	dispatch_async(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		[sself.dataStore removeAllObjects];
-	});
+	CWQueueLock();
+	[self.dataStore removeAllObjects];
+	if (_log) {
+		[_log removeAllRecords];
+		_memorySequence = _log.tailSequence;
+	}
+	CWQueueUnlock();
 }
 
 #pragma mark Query Methods -
 
 -(BOOL)containsObject:(id)object {
+	CWQueueLock();
 	__block BOOL contains = NO;
-	__typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		contains = [sself.dataStore containsObject:object];
-	});
+	[self _enumerateQueuedObjectsUsingBlock:^(id obj, BOOL *stop) {
+		if ([obj isEqual:object]) {
+			contains = YES;
+			*stop = YES;
+		}
+	}];
+	CWQueueUnlock();
 	return contains;
 }
 
 -(BOOL)containsObjectWithBlock:(BOOL (^)(id obj))block {
+	CWQueueLock();
 	__block BOOL contains = NO;
-	__typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		NSUInteger index = [sself.dataStore indexOfObjectPassingTest:^BOOL(id obj, NSUInteger idx, BOOL *stop) {
-			return block(obj);
-		}];
-		contains = (index != NSNotFound);
-	});
+	[self _enumerateQueuedObjectsUsingBlock:^(id obj, BOOL *stop) {
+		if (block(obj)) {
+			contains = YES;
+			*stop = YES;
+		}
+	}];
+	CWQueueUnlock();
 	return contains;
 }
 
 -(id)peek {
-	__block id object = nil;
-	__typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		if (sself.dataStore.count >= 1) {
-			object = sself.dataStore[0];
-		}
-	});
+	id object = nil;
+	CWQueueLock();
+	CWStatisticsCount(_statistics.peekCount);
+	if (_log) {
+		object = [self _durableHeadObject];
+	} else if (self.dataStore.count >= 1) {
+		object = self.dataStore[0];
+	}
+	CWQueueUnlock();
 	return object;
 }
 
 #pragma mark Enumeration Methods -
 
 -(void)enumerateObjectsInQueue:(void(^)(id object, BOOL *stop))block {
-	__typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		BOOL shouldStop = NO;
-		for (id object in sself.dataStore) {
-			block(object,&shouldStop);
-			if (shouldStop) return;
-		}
-	});
+	CWQueueLock();
+	[self _enumerateQueuedObjectsUsingBlock:block];
+	CWQueueUnlock();
 }
 
 -(void)dequeueOueueWithBlock:(void(^)(id object, BOOL *stop))block {
-	if(self.dataStore.count == 0) return;
+	if([self isEmpty]) return;
 	
 	BOOL shouldStop = NO;
 	id dequeuedObject = nil;
@@ -195,13 +480,56 @@ static int64_t queueCounter = 0;
 
 -(void)dequeueToObject:(id)targetObject 
 			 withBlock:(void(^)(id object))block {
-	if (![self.dataStore containsObject:targetObject]) return;
+	if (![self containsObject:targetObject]) return;
 	[self dequeueOueueWithBlock:^(id object, BOOL *stop) {
 		block(object);
 		if ([object isEqual:targetObject]) *stop = YES;
 	}];
 }
 
+#pragma mark NSFastEnumeration -
+
+/**
+ Unsynchronized queues hand enumeration straight to dataStore, which gives out
+ pointers into its own storage & raises if the queue is mutated mid loop.
+ Synchronized queues can't hold the lock for the length of a for...in loop, so
+ they take a snapshot under the lock on the first call & give it out in chunks.
+ The snapshot is autoreleased so it lives as long as the loop does, extra[0]
+ holds it, extra[1] is the (never changing) mutations value & extra[2] is the
+ index of the next object to hand out. For a durable queue the snapshot means
+ decoding the whole backlog up front, the header points big backlogs at
+ -enumerateObjectsInQueue: instead.
+ */
+-(NSUInteger)countByEnumeratingWithState:(NSFastEnumerationState *)state
+								 objects:(id __unsafe_unretained [])buffer
+								   count:(NSUInteger)len {
+	if (!_synchronized) {
+		return [self.dataStore countByEnumeratingWithState:state objects:buffer count:len];
+	}
+	
+	if (state->state == 0) {
+		CWQueueLock();
+		NSArray * __autoreleasing snapshot = [[self _queuedObjects] copy];
+		CWQueueUnlock();
+		state->state = 1;
+		state->extra[0] = (unsigned long)(__bridge void *)snapshot;
+		state->extra[1] = 0;
+		state->extra[2] = 0;
+		state->mutationsPtr = &state->extra[1];
+	}
+	
+	NSArray *snapshot = (__bridge NSArray *)(void *)state->extra[0];
+	NSUInteger index = state->extra[2];
+	NSUInteger remaining = snapshot.count - index;
+	if (remaining == 0 || len == 0) return 0;
+	
+	NSUInteger chunk = MIN(remaining, len);
+	[snapshot getObjects:buffer range:NSMakeRange(index, chunk)];
+	state->itemsPtr = buffer;
+	state->extra[2] = index + chunk;
+	return chunk;
+}
+
 #pragma mark Debug Information -
 
 /**
@@ -210,45 +538,68 @@ static int64_t queueCounter = 0;
  @return a NSString detailing the queues internal storage
  */
 -(NSString *)description {
-	__block NSString *queueDescription = nil;
-	__typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		queueDescription = [sself.dataStore description];
-	});
+	CWQueueLock();
+	NSString *queueDescription = [[self _queuedObjects] description];
+	CWQueueUnlock();
 	return queueDescription;
 }
 
 -(NSUInteger)count {
-	__block NSUInteger queueCount = 0;
-	__typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		queueCount = sself.dataStore.count;
-	});
+	CWQueueLock();
+	NSUInteger queueCount = _log ? _log.count : self.dataStore.count;
+	CWQueueUnlock();
 	return queueCount;
 }
 
 -(BOOL)isEmpty {
-	__block BOOL queueEmpty = YES;
-	__typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		queueEmpty = (sself.dataStore.count == 0);
-	});
+	CWQueueLock();
+	BOOL queueEmpty = _log ? (_log.count == 0) : (self.dataStore.count == 0);
+	CWQueueUnlock();
 	return queueEmpty;
 }
 
 #pragma mark Comparison -
 
 -(BOOL)isEqualToQueue:(CWQueue *)aQueue {
-	__block BOOL isEqual = NO;
-	__typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		isEqual = [sself.dataStore isEqual:aQueue.dataStore];
-	});
-	return isEqual;
+	if (aQueue == nil) return NO;
+	//take aQueues objects under its own lock, never hold both locks at once
+	NSArray *otherObjects = [aQueue _queuedObjectsSnapshot];
+	CWQueueLock();
+	//compare as the objects are reached so a durable queue stops decoding at
+	//the first difference
+	__block BOOL isEqual = YES;
+	__block NSUInteger index = 0;
+	[self _enumerateQueuedObjectsUsingBlock:^(id object, BOOL *stop) {
+		if (index == otherObjects.count || ![object isEqual:otherObjects[index]]) {
+			isEqual = NO;
+			*stop = YES;
+		}
+		index++;
+	}];
+	CWQueueUnlock();
+	return isEqual && (index == otherObjects.count);
+}
+
+-(NSArray *)_queuedObjectsSnapshot {
+	CWQueueLock();
+	NSArray *snapshot = [[self _queuedObjects] copy];
+	CWQueueUnlock();
+	return snapshot;
 }
 
+#if CW_STATISTICS
+
+#pragma mark Statistics -
+
+-(NSDictionary *)statistics {
+	return @{ @"enqueueCount" : @(CWStatisticsLoad(&_statistics.enqueueCount)),
+			  @"dequeueCount" : @(CWStatisticsLoad(&_statistics.dequeueCount)),
+			  @"emptyDequeueCount" : @(CWStatisticsLoad(&_statistics.emptyDequeueCount)),
+			  @"peekCount" : @(CWStatisticsLoad(&_statistics.peekCount)),
+			  @"highWaterCount" : @(CWStatisticsLoad(&_statistics.highWaterCount)),
+			  @"waitTime" : CWStatisticsWaitHistogramDictionary(&_statistics.wait) };
+}
+
+#endif
+
 @end
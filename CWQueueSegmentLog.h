@@ -0,0 +1,267 @@
+/*
+//  CWQueueSegmentLog.h
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+  /*
+ This class should not make any use of the Zangetsu Framework API's so it can
+ retain its independence and be used in other projects not making use of the
+ Zangetsu Framework.
+  */
+
+#import <Foundation/Foundation.h>
+
+/**
+ How a CWQueueSegmentLog gets its records onto disk
+ 
+ Records are written into memory mapped files, so once an append returns the
+ record survives the process crashing. These policies decide what survives the
+ machine crashing or losing power.
+ 
+ CWQueueSyncPolicyNone never syncs, the OS writes records back in its own time.
+ CWQueueSyncPolicyInterval syncs on a background queue every
+ kCWQueueSegmentLogSyncInterval, at most that long worth of records can be lost.
+ CWQueueSyncPolicyEveryWrite is for owners that call -syncThroughSequence:
+ after every append, as a durable CWQueue does in -enqueue:. Threads waiting at
+ the same time share one sync (group commit) so the cost of a sync is spread
+ over every record it covers.
+ */
+typedef NS_ENUM(NSUInteger, CWQueueSyncPolicy) {
+	CWQueueSyncPolicyNone,
+	CWQueueSyncPolicyInterval,
+	CWQueueSyncPolicyEveryWrite
+};
+
+/**
+ The default size of a segment file, 64 MB
+ */
+#define kCWQueueSegmentLogDefaultSegmentSize (64 * 1024 * 1024)
+
+/**
+ The interval CWQueueSyncPolicyInterval syncs at, 10 ms
+ */
+#define kCWQueueSegmentLogSyncInterval 0.01
+
+/**
+ CWQueueSegmentLog
+ 
+ An append only log of records stored in a directory of fixed size, memory
+ mapped segment files. It is the storage behind a durable CWQueue but knows
+ nothing about objects, a record is just a type byte & some bytes.
+ 
+ Records are appended at the tail & consumed from the head. The head position
+ is checkpointed to a small file of its own on every -advanceHead so consumed
+ records aren't handed out again after a restart, and a segment file is deleted
+ once every record in it has been consumed.
+ 
+ Every record carries a checksum. When a log is opened only the last segment
+ is scanned, to find where the last complete record ends, so recovery time
+ depends on the segment size & not on how many records are in the log. The
+ other segments are checked as they are read instead: every record read has
+ its length & checksum checked. A corrupt record ends its segment, since the
+ records after it can't be found without trusting its length, and a segment
+ that is missing or has a damaged header is skipped entirely. The records lost
+ that way are discarded & counted in discardedRecordCount, they are never
+ handed out & never stop the log.
+ 
+ Appending, reading & advancing the head are not thread safe, the owner (a
+ CWQueue holding its lock) must make sure only one thread does so at a time.
+ -sync & -syncThroughSequence: are thread safe & are meant to be called
+ without holding that lock so other threads can append while one waits.
+ */
+
+@interface CWQueueSegmentLog : NSObject
+
+/**
+ Opens the log in directory, creating the directory & log if needed
+ 
+ If the directory already has a log its records are recovered, the log will
+ have the records that were appended but not consumed before it was last
+ closed (less whatever the sync policy allowed to be lost in a crash).
+ 
+ @param directory the directory the segment & checkpoint files live in
+ @param segmentSize the size of each segment file, records bigger than this get
+ a segment of their own
+ @param syncPolicy how records get onto disk
+ @param error if the log can't be opened this is set to an error describing why
+ @return an initialized CWQueueSegmentLog or nil if the log couldn't be opened
+ */
+-(instancetype)initWithDirectory:(NSString *)directory
+					 segmentSize:(NSUInteger)segmentSize
+					  syncPolicy:(CWQueueSyncPolicy)syncPolicy
+						   error:(NSError **)error;
+
+@property(readonly) NSString *directory;
+@property(readonly) NSUInteger segmentSize;
+@property(readonly) CWQueueSyncPolicy syncPolicy;
+
+/**
+ The sequence number of the record at the head of the log
+ 
+ Every record gets the next sequence number when it is appended, the log holds
+ the records from headSequence up to (not including) tailSequence.
+ */
+@property(readonly) uint64_t headSequence;
+
+/**
+ The sequence number the next appended record will get
+ */
+@property(readonly) uint64_t tailSequence;
+
+/**
+ Returns the number of records in the log
+ */
+-(NSUInteger)count;
+
+/**
+ The number of records discarded since the log was opened
+ 
+ This counts records lost to corrupt records & damaged or missing segments as
+ well as records the owner discarded with -discardHeadRecordForReason:.
+ */
+@property(readonly) uint64_t discardedRecordCount;
+
+/**
+ An error describing the last time records were discarded or a problem was
+ found opening the log, such as a gap in the segment files, nil if there has
+ been none
+ */
+@property(readonly) NSError *lastError;
+
+/**
+ Appends a record to the tail of the log
+ 
+ @param bytes the bytes of the record
+ @param length the number of bytes in the record
+ @param type a nonzero type the record is tagged with
+ @param sequence if not NULL set to the sequence number of the record
+ @return YES if the record was appended, NO if a new segment file could not be
+ created for it
+ */
+-(BOOL)appendBytes:(const void *)bytes
+			length:(NSUInteger)length
+			  type:(uint8_t)type
+		  sequence:(uint64_t *)sequence;
+
+/**
+ Appends several records to the tail of the log, either all of them or none
+ 
+ Every segment the records need is created before any record is written, so
+ if one can't be created the log is left as it was.
+ 
+ @param records the NSData records to append, in order
+ @param types the nonzero type of each record
+ @param sequence if not NULL set to the sequence number of the last record
+ @param error if the records couldn't be appended this is set to an error
+ describing why
+ @return YES if every record was appended, NO if none were
+ */
+-(BOOL)appendRecords:(NSArray *)records
+			   types:(const uint8_t *)types
+		lastSequence:(uint64_t *)sequence
+			   error:(NSError **)error;
+
+/**
+ Calls block with the record at the head of the log without consuming it
+ 
+ bytes points into the memory mapped segment & is only valid during the block.
+ 
+ @param block the block called with the head record
+ @return YES if block was called, NO if the log was empty
+ */
+-(BOOL)readHeadRecordUsingBlock:(void (^)(const void *bytes, NSUInteger length, uint8_t type))block;
+
+/**
+ Consumes the record at the head of the log
+ 
+ @return YES if a record was consumed, NO if the log was empty
+ */
+-(BOOL)advanceHead;
+
+/**
+ Consumes the record at the head of the log & counts it as discarded
+ 
+ For owners that can't make sense of a record, so it doesn't stop the log.
+ 
+ @param reason an error describing why the record was discarded, becomes the
+ logs lastError
+ @return YES if a record was discarded, NO if the log was empty
+ */
+-(BOOL)discardHeadRecordForReason:(NSError *)reason;
+
+/**
+ Calls block with each record from the head to the tail of the log
+ 
+ Records that would be discarded when they reach the head are skipped.
+ 
+ @param block the block called for each record, bytes is only valid during the
+ block. Set stop to YES to stop enumerating.
+ */
+-(void)enumerateRecordsUsingBlock:(void (^)(const void *bytes, NSUInteger length, uint8_t type, BOOL *stop))block;
+
+/**
+ Calls block with each record from the head of the log up to (not including)
+ the record with endSequence
+ 
+ Records that would be discarded when they reach the head are skipped.
+ 
+ @param endSequence the sequence number to stop enumerating at
+ @param block the block called for each record, bytes is only valid during the
+ block. Set stop to YES to stop enumerating.
+ */
+-(void)enumerateRecordsBeforeSequence:(uint64_t)endSequence
+						   usingBlock:(void (^)(const void *bytes, NSUInteger length, uint8_t type, BOOL *stop))block;
+
+/**
+ Consumes every record in the log
+ */
+-(void)removeAllRecords;
+
+/**
+ Waits until every record before sequence is on disk
+ 
+ If another thread is already syncing this waits for it & then only syncs if
+ its sync didn't cover sequence. Thread safe.
+ 
+ @param sequence the sequence number after the last record to wait for
+ */
+-(void)syncThroughSequence:(uint64_t)sequence;
+
+/**
+ Waits until every record appended so far & the head checkpoint are on disk
+ 
+ This covers every segment filled since the last sync, including those left by
+ a previous process, whatever the sync policy. With CWQueueSyncPolicyNone the OS
+ is also asked to start writing back a segment when it fills, so there is
+ usually little left to wait for. Thread safe.
+ */
+-(void)sync;
+
+@end
@@ -0,0 +1,913 @@
+/*
+//  CWQueueSegmentLog.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWQueueSegmentLog.h"
+#import "CWAssertionMacros.h"
+#import "CWLock.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+
+#define kCWQueueSegmentMagic 0x53515743 //"CWQS"
+#define kCWQueueCheckpointMagic 0x50515743 //"CWQP"
+#define kCWQueueSegmentLogVersion 1
+#define kCWQueueSegmentLogMinimumSegmentSize (64 * 1024)
+#define kCWQueueSegmentLogCheckpointFile @"head.checkpoint"
+#define kCWQueueSegmentLogSegmentExtension @"segment"
+
+/*
+ File formats
+ 
+ A segment file starts with a CWQueueSegmentHeader followed by records, each a
+ CWQueueRecordHeader & its bytes padded to 8 bytes. Segment files are created
+ at their full size & zero filled, so a record header with a type of 0 marks
+ the end of the records in a segment. Records never span segments, when one
+ doesn't fit the rest of the segment is left zeroed & a new segment started.
+ Segment files are named after their index in hex so they sort in order.
+ 
+ The checkpoint file holds two CWQueueCheckpoint slots which are written
+ alternately, so if a crash tears one write the other slot still has the
+ previous head. The slot with the highest generation & a valid checksum wins.
+ */
+
+typedef struct CWQueueSegmentHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t index;
+	uint64_t firstSequence;
+	uint64_t reserved;
+} CWQueueSegmentHeader;
+
+typedef struct CWQueueRecordHeader {
+	uint32_t length;
+	uint32_t checksum;
+	uint8_t type;
+	uint8_t reserved[7];
+} CWQueueRecordHeader;
+
+typedef struct CWQueueCheckpoint {
+	uint32_t magic;
+	uint32_t checksum;
+	uint64_t generation;
+	uint64_t segmentIndex;
+	uint64_t offset;
+	uint64_t sequence;
+} CWQueueCheckpoint;
+
+#define CWQueueRecordSize(length) ((sizeof(CWQueueRecordHeader) + (size_t)(length) + 7) & ~(size_t)7)
+
+typedef NS_ENUM(NSUInteger, CWQueueRecordStatus) {
+	//no more records in the segment
+	CWQueueRecordStatusEnd,
+	CWQueueRecordStatusValid,
+	//a record whose length runs past the segment or whose checksum is wrong
+	CWQueueRecordStatusCorrupt
+};
+
+#pragma mark Checksums -
+
+static uint32_t CWQueueCRCTable[256];
+
+static void CWQueueCRCTableInit(void) {
+	for (uint32_t i = 0; i < 256; i++) {
+		uint32_t crc = i;
+		for (int bit = 0; bit < 8; bit++) crc = (crc & 1) ? (0xEDB88320 ^ (crc >> 1)) : (crc >> 1);
+		CWQueueCRCTable[i] = crc;
+	}
+}
+
+static uint32_t CWQueueCRC32(uint32_t crc, const void *bytes, size_t length) {
+	const uint8_t *byte = bytes;
+	crc = ~crc;
+	while (length--) crc = CWQueueCRCTable[(crc ^ *byte++) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+static uint32_t CWQueueRecordChecksum(uint32_t length, uint8_t type, const void *bytes) {
+	uint32_t crc = CWQueueCRC32(0, &length, sizeof(length));
+	crc = CWQueueCRC32(crc, &type, sizeof(type));
+	return CWQueueCRC32(crc, bytes, length);
+}
+
+static uint32_t CWQueueCheckpointChecksum(const CWQueueCheckpoint *checkpoint) {
+	return CWQueueCRC32(0, &checkpoint->generation, sizeof(CWQueueCheckpoint) - offsetof(CWQueueCheckpoint, generation));
+}
+
+static NSError *CWQueueSegmentLogPOSIXError(NSString *path) {
+	return [NSError errorWithDomain:NSPOSIXErrorDomain
+							   code:errno
+						   userInfo:@{ NSFilePathErrorKey : path }];
+}
+
+#pragma mark Segment -
+
+/**
+ A memory mapped segment file. The mapping lives as long as the object, so the
+ syncing thread can hold on to a segment the appender has moved past.
+ */
+@interface CWQueueSegment : NSObject {
+@public
+	uint64_t _index;
+	uint64_t _firstSequence;
+	int _fd;
+	uint8_t *_bytes;
+	size_t _size;
+	//where the records end once the segment is full, set when the log moves on
+	size_t _endOffset;
+	//only touched by the thread syncing
+	size_t _syncedOffset;
+}
+@end
+
+@implementation CWQueueSegment
+
+-(instancetype)initWithPath:(NSString *)path
+					  index:(uint64_t)index
+			  firstSequence:(uint64_t)firstSequence
+					   size:(size_t)size
+					  error:(NSError **)error {
+	self = [super init];
+	if (self == nil) return nil;
+	
+	_fd = open(path.fileSystemRepresentation, O_RDWR | O_CREAT | O_EXCL, 0644);
+	if (_fd < 0) {
+		if (error) *error = CWQueueSegmentLogPOSIXError(path);
+		return nil;
+	}
+	int result = ftruncate(_fd, (off_t)size);
+#if defined(__linux__)
+	//reserve the blocks now so running out of disk space is an error here
+	//instead of a SIGBUS when the mapping is written to
+	if (result == 0) result = posix_fallocate(_fd, 0, (off_t)size) == 0 ? 0 : -1;
+#endif
+	if (result != 0 || ![self _mapWithSize:size]) {
+		if (error) *error = CWQueueSegmentLogPOSIXError(path);
+		unlink(path.fileSystemRepresentation);
+		return nil;
+	}
+	
+	CWQueueSegmentHeader *header = (CWQueueSegmentHeader *)_bytes;
+	header->magic = kCWQueueSegmentMagic;
+	header->version = kCWQueueSegmentLogVersion;
+	header->index = index;
+	header->firstSequence = firstSequence;
+	_index = index;
+	_firstSequence = firstSequence;
+	
+	return self;
+}
+
+-(instancetype)initWithExistingPath:(NSString *)path error:(NSError **)error {
+	self = [super init];
+	if (self == nil) return nil;
+	
+	_fd = open(path.fileSystemRepresentation, O_RDWR);
+	struct stat info;
+	if (_fd < 0 || fstat(_fd, &info) != 0) {
+		if (error) *error = CWQueueSegmentLogPOSIXError(path);
+		return nil;
+	}
+	if ((size_t)info.st_size < sizeof(CWQueueSegmentHeader) || ![self _mapWithSize:(size_t)info.st_size]) {
+		if (error) *error = CWQueueSegmentLogPOSIXError(path);
+		return nil;
+	}
+	
+	CWQueueSegmentHeader *header = (CWQueueSegmentHeader *)_bytes;
+	if (header->magic != kCWQueueSegmentMagic || header->version != kCWQueueSegmentLogVersion) {
+		if (error) *error = [NSError errorWithDomain:NSCocoaErrorDomain
+												code:NSFileReadCorruptFileError
+											userInfo:@{ NSFilePathErrorKey : path }];
+		return nil;
+	}
+	_index = header->index;
+	_firstSequence = header->firstSequence;
+	//a crashed process can leave dirty pages behind, so nothing counts as
+	//synced until this process syncs it
+	_syncedOffset = 0;
+	
+	return self;
+}
+
+-(BOOL)_mapWithSize:(size_t)size {
+	void *bytes = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+	if (bytes == MAP_FAILED) return NO;
+	_bytes = bytes;
+	_size = size;
+	return YES;
+}
+
+-(void)dealloc {
+	if (_bytes) munmap(_bytes, _size);
+	if (_fd >= 0) close(_fd);
+}
+
+/**
+ Syncs the bytes before offset that haven't been synced yet
+ */
+-(void)syncThroughOffset:(size_t)offset {
+	if (offset <= _syncedOffset) return;
+	size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	size_t start = _syncedOffset & ~(pageSize - 1);
+	msync(_bytes + start, offset - start, MS_SYNC);
+	_syncedOffset = offset;
+}
+
+/**
+ Finds the record at offset, checking that its length fits in the segment and
+ that its checksum matches before handing it back in record
+ */
+-(CWQueueRecordStatus)recordAtOffset:(size_t)offset record:(CWQueueRecordHeader **)record {
+	if (offset + sizeof(CWQueueRecordHeader) > _size) return CWQueueRecordStatusEnd;
+	CWQueueRecordHeader *header = (CWQueueRecordHeader *)(_bytes + offset);
+	if (header->type == 0) return CWQueueRecordStatusEnd;
+	if (header->length > _size - offset - sizeof(CWQueueRecordHeader)) return CWQueueRecordStatusCorrupt;
+	if (header->checksum != CWQueueRecordChecksum(header->length, header->type, header + 1)) return CWQueueRecordStatusCorrupt;
+	*record = header;
+	return CWQueueRecordStatusValid;
+}
+
+@end
+
+#pragma mark Log -
+
+@interface CWQueueSegmentLog () {
+	//the appending side, guarded by _stateLock against the syncing thread
+	CWLock _stateLock;
+	CWQueueSegment *_writeSegment;
+	size_t _writeOffset;
+	NSMutableArray *_unsyncedSegments;
+	//full segments that aren't in _unsyncedSegments but may not be on disk,
+	//those recovered when the log was opened & with CWQueueSyncPolicyNone
+	//those filled since, from _unsyncedFirstIndex up to _unsyncedEndIndex
+	uint64_t _unsyncedFirstIndex;
+	uint64_t _unsyncedEndIndex;
+	BOOL _directoryChanged;
+	
+	//the consuming side, only touched by the owner
+	CWQueueSegment *_readSegment;
+	size_t _readOffset;
+	//the record at the read position once its checksum has been checked
+	CWQueueRecordHeader *_validatedHeadRecord;
+	int _checkpointFD;
+	CWQueueCheckpoint *_checkpoints;
+	uint64_t _checkpointGeneration;
+	
+	int _directoryFD;
+	pthread_mutex_t _syncMutex;
+	pthread_cond_t _syncCondition;
+	BOOL _syncing;
+	uint64_t _durableSequence;
+	dispatch_source_t _syncTimer;
+}
+@end
+
+@implementation CWQueueSegmentLog
+
+#pragma mark Initialization -
+
+-(instancetype)initWithDirectory:(NSString *)directory
+					 segmentSize:(NSUInteger)segmentSize
+					  syncPolicy:(CWQueueSyncPolicy)syncPolicy
+						   error:(NSError **)error {
+	self = [super init];
+	if (self == nil) return nil;
+	
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+		CWQueueCRCTableInit();
+	});
+	
+	_directory = [directory copy];
+	_segmentSize = MAX(segmentSize, (NSUInteger)kCWQueueSegmentLogMinimumSegmentSize);
+	_syncPolicy = syncPolicy;
+	_unsyncedSegments = [NSMutableArray array];
+	_checkpointFD = -1;
+	_directoryFD = -1;
+	CWLockInit(&_stateLock);
+	pthread_mutex_init(&_syncMutex, NULL);
+	pthread_cond_init(&_syncCondition, NULL);
+	
+	if (![[NSFileManager defaultManager] createDirectoryAtPath:directory
+								   withIntermediateDirectories:YES
+													attributes:nil
+														 error:error]) {
+		return nil;
+	}
+	_directoryFD = open(directory.fileSystemRepresentation, O_RDONLY);
+	if (_directoryFD < 0) {
+		if (error) *error = CWQueueSegmentLogPOSIXError(directory);
+		return nil;
+	}
+	if (![self _openCheckpointWithError:error]) return nil;
+	if (![self _recoverWithError:error]) return nil;
+	_durableSequence = _tailSequence;
+	
+	if (syncPolicy == CWQueueSyncPolicyInterval) {
+		_syncTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0));
+		uint64_t interval = (uint64_t)(kCWQueueSegmentLogSyncInterval * NSEC_PER_SEC);
+		dispatch_source_set_timer(_syncTimer, dispatch_time(DISPATCH_TIME_NOW, (int64_t)interval), interval, interval / 10);
+		__weak CWQueueSegmentLog *weakSelf = self;
+		dispatch_source_set_event_handler(_syncTimer, ^{
+			[weakSelf sync];
+		});
+		dispatch_resume(_syncTimer);
+	}
+	
+	return self;
+}
+
+-(void)dealloc {
+	if (_syncTimer) dispatch_source_cancel(_syncTimer);
+	if (_syncPolicy != CWQueueSyncPolicyNone && _writeSegment != nil) [self _syncWrittenRecords];
+	if (_checkpoints) munmap(_checkpoints, (size_t)sysconf(_SC_PAGESIZE));
+	if (_checkpointFD >= 0) close(_checkpointFD);
+	if (_directoryFD >= 0) close(_directoryFD);
+	pthread_cond_destroy(&_syncCondition);
+	pthread_mutex_destroy(&_syncMutex);
+	CWLockDestroy(&_stateLock);
+}
+
+-(NSString *)_pathForSegmentIndex:(uint64_t)index {
+	NSString *name = [NSString stringWithFormat:@"%016llx.%@", (unsigned long long)index, kCWQueueSegmentLogSegmentExtension];
+	return [self.directory stringByAppendingPathComponent:name];
+}
+
+#pragma mark Recovery -
+
+-(BOOL)_openCheckpointWithError:(NSError **)error {
+	NSString *path = [self.directory stringByAppendingPathComponent:kCWQueueSegmentLogCheckpointFile];
+	size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	_checkpointFD = open(path.fileSystemRepresentation, O_RDWR | O_CREAT, 0644);
+	struct stat info;
+	if (_checkpointFD < 0 || fstat(_checkpointFD, &info) != 0 ||
+		((size_t)info.st_size < pageSize && ftruncate(_checkpointFD, (off_t)pageSize) != 0)) {
+		if (error) *error = CWQueueSegmentLogPOSIXError(path);
+		return NO;
+	}
+	void *bytes = mmap(NULL, pageSize, PROT_READ | PROT_WRITE, MAP_SHARED, _checkpointFD, 0);
+	if (bytes == MAP_FAILED) {
+		if (error) *error = CWQueueSegmentLogPOSIXError(path);
+		return NO;
+	}
+	_checkpoints = bytes;
+	return YES;
+}
+
+/**
+ Returns the newest valid checkpoint or NULL if there isn't one
+ */
+-(const CWQueueCheckpoint *)_latestCheckpoint {
+	const CWQueueCheckpoint *latest = NULL;
+	for (NSUInteger slot = 0; slot < 2; slot++) {
+		const CWQueueCheckpoint *checkpoint = &_checkpoints[slot];
+		if (checkpoint->magic != kCWQueueCheckpointMagic) continue;
+		if (checkpoint->checksum != CWQueueCheckpointChecksum(checkpoint)) continue;
+		if (latest == NULL || checkpoint->generation > latest->generation) latest = checkpoint;
+	}
+	return latest;
+}
+
+-(NSArray *)_segmentIndexesOnDisk {
+	NSMutableArray *indexes = [NSMutableArray array];
+	for (NSString *name in [[NSFileManager defaultManager] contentsOfDirectoryAtPath:self.directory error:NULL]) {
+		if (![name.pathExtension isEqualToString:kCWQueueSegmentLogSegmentExtension]) continue;
+		unsigned long long index = 0;
+		NSScanner *scanner = [NSScanner scannerWithString:name.stringByDeletingPathExtension];
+		if (![scanner scanHexLongLong:&index] || !scanner.isAtEnd) continue;
+		[indexes addObject:@(index)];
+	}
+	[indexes sortUsingSelector:@selector(compare:)];
+	return indexes;
+}
+
+/**
+ Finds the tail by scanning the last segment & the head from the checkpoint.
+ Segments before the last one were complete before the next one was started
+ so they are never scanned, which keeps recovery time independent of how big
+ the backlog is.
+ */
+-(BOOL)_recoverWithError:(NSError **)error {
+	const CWQueueCheckpoint *checkpoint = [self _latestCheckpoint];
+	_checkpointGeneration = checkpoint ? checkpoint->generation : 0;
+	NSMutableArray *indexes = [[self _segmentIndexesOnDisk] mutableCopy];
+	
+	//a crash while creating a segment can leave it without a header
+	while (indexes.count > 0 && _writeSegment == nil) {
+		uint64_t index = [indexes.lastObject unsignedLongLongValue];
+		NSString *path = [self _pathForSegmentIndex:index];
+		_writeSegment = [[CWQueueSegment alloc] initWithExistingPath:path error:NULL];
+		if (_writeSegment == nil || _writeSegment->_index != index) {
+			_writeSegment = nil;
+			unlink(path.fileSystemRepresentation);
+			[indexes removeLastObject];
+		}
+	}
+	
+	if (_writeSegment == nil) {
+		uint64_t index = checkpoint ? checkpoint->segmentIndex : 0;
+		uint64_t sequence = checkpoint ? checkpoint->sequence : 0;
+		_writeSegment = [[CWQueueSegment alloc] initWithPath:[self _pathForSegmentIndex:index]
+													   index:index
+											   firstSequence:sequence
+														size:self.segmentSize
+													   error:error];
+		if (_writeSegment == nil) return NO;
+		_directoryChanged = YES;
+		[indexes addObject:@(index)];
+	}
+	
+	//scan the last segment for the end of the last complete record
+	//a corrupt record here is one torn by a crash, so it ends the log
+	size_t offset = sizeof(CWQueueSegmentHeader);
+	uint64_t count = 0;
+	CWQueueRecordHeader *record = NULL;
+	while ([_writeSegment recordAtOffset:offset record:&record] == CWQueueRecordStatusValid) {
+		offset += CWQueueRecordSize(record->length);
+		count++;
+	}
+	_writeOffset = offset;
+	_tailSequence = _writeSegment->_firstSequence + count;
+	[self _zeroSegment:_writeSegment fromOffset:offset];
+	_unsyncedFirstIndex = [indexes[0] unsignedLongLongValue];
+	_unsyncedEndIndex = _writeSegment->_index;
+	
+	//the head is the checkpoint unless the segment it points to has been
+	//consumed & deleted or the records it points past were lost
+	uint64_t firstIndex = [indexes[0] unsignedLongLongValue];
+	uint64_t readIndex = firstIndex;
+	size_t readOffset = sizeof(CWQueueSegmentHeader);
+	BOOL headFromCheckpoint = NO;
+	if (checkpoint && checkpoint->segmentIndex >= firstIndex) {
+		headFromCheckpoint = YES;
+		if (checkpoint->segmentIndex > _writeSegment->_index ||
+			checkpoint->sequence > _tailSequence ||
+			(checkpoint->segmentIndex == _writeSegment->_index && checkpoint->offset > _writeOffset)) {
+			readIndex = _writeSegment->_index;
+			readOffset = _writeOffset;
+			_headSequence = _tailSequence;
+		} else {
+			readIndex = checkpoint->segmentIndex;
+			readOffset = (size_t)checkpoint->offset;
+			_headSequence = checkpoint->sequence;
+		}
+	}
+	
+	if (readIndex == _writeSegment->_index) {
+		_readSegment = _writeSegment;
+	} else {
+		_readSegment = [self _existingSegmentAtIndex:readIndex];
+	}
+	_readOffset = readOffset;
+	if (_readSegment == nil) {
+		//the head segment is damaged or gone, carry on from the next intact one
+		CWQueueSegment *segment = [self _segmentAfterIndex:readIndex minimumSequence:(headFromCheckpoint ? _headSequence : 0)];
+		if (!headFromCheckpoint) _headSequence = segment->_firstSequence;
+		_lastError = [self _errorForSegmentIndex:readIndex
+									 description:@"The segment holding the head of the log is damaged or missing"];
+		[self _moveHeadToSegment:segment];
+	} else if (!headFromCheckpoint) {
+		_headSequence = _readSegment->_firstSequence;
+	}
+	
+	//segments are numbered consecutively, so a gap means a segment went missing
+	uint64_t expectedIndex = _readSegment->_index;
+	for (NSNumber *index in indexes) {
+		uint64_t value = index.unsignedLongLongValue;
+		if (value < expectedIndex) continue;
+		if (value != expectedIndex) {
+			_lastError = [self _errorForSegmentIndex:expectedIndex
+										 description:@"A segment of the log is missing, its records will be skipped"];
+			break;
+		}
+		expectedIndex++;
+	}
+	
+	for (NSNumber *index in indexes) {
+		if (index.unsignedLongLongValue >= _readSegment->_index) break;
+		unlink([self _pathForSegmentIndex:index.unsignedLongLongValue].fileSystemRepresentation);
+	}
+	[self _writeCheckpoint];
+	return YES;
+}
+
+#pragma mark Damaged Segments -
+
+-(NSError *)_errorForSegmentIndex:(uint64_t)index description:(NSString *)description {
+	return [NSError errorWithDomain:NSCocoaErrorDomain
+							   code:NSFileReadCorruptFileError
+						   userInfo:@{ NSFilePathErrorKey : [self _pathForSegmentIndex:index],
+									   NSLocalizedDescriptionKey : description }];
+}
+
+/**
+ Opens the segment with index, returning nil if it is missing or its header is
+ damaged
+ */
+-(CWQueueSegment *)_existingSegmentAtIndex:(uint64_t)index {
+	CWQueueSegment *segment = [[CWQueueSegment alloc] initWithExistingPath:[self _pathForSegmentIndex:index] error:NULL];
+	if (segment == nil || segment->_index != index) return nil;
+	if (segment->_firstSequence > _writeSegment->_firstSequence) return nil;
+	return segment;
+}
+
+/**
+ Returns the first intact segment after index, skipping segments that are
+ missing, have a damaged header or start before minimumSequence. The segment
+ being appended to is always intact, so this never returns nil.
+ */
+-(CWQueueSegment *)_segmentAfterIndex:(uint64_t)index minimumSequence:(uint64_t)minimumSequence {
+	uint64_t writeIndex = _writeSegment->_index;
+	NSArray *indexesOnDisk = nil;
+	uint64_t next = index + 1;
+	while (next < writeIndex) {
+		CWQueueSegment *segment = [self _existingSegmentAtIndex:next];
+		if (segment && segment->_firstSequence >= minimumSequence) return segment;
+		//list the directory once instead of trying every index in a big gap
+		if (indexesOnDisk == nil) indexesOnDisk = [self _segmentIndexesOnDisk];
+		uint64_t candidate = writeIndex;
+		for (NSNumber *onDisk in indexesOnDisk) {
+			if (onDisk.unsignedLongLongValue > next) {
+				candidate = MIN(onDisk.unsignedLongLongValue, writeIndex);
+				break;
+			}
+		}
+		next = candidate;
+	}
+	return _writeSegment;
+}
+
+/**
+ Moves the read position to the start of segment. Records between the head &
+ the first record of segment were in a damaged or missing segment & are
+ counted as discarded.
+ */
+-(void)_moveHeadToSegment:(CWQueueSegment *)segment {
+	if (segment->_firstSequence > _headSequence) {
+		uint64_t lost = segment->_firstSequence - _headSequence;
+		_discardedRecordCount += lost;
+		_lastError = [self _errorForSegmentIndex:segment->_index
+									 description:[NSString stringWithFormat:@"%llu records before this segment were lost to a damaged or missing segment",
+												  (unsigned long long)lost]];
+		_headSequence = segment->_firstSequence;
+	}
+	_readSegment = segment;
+	_readOffset = sizeof(CWQueueSegmentHeader);
+	_validatedHeadRecord = NULL;
+	[self _writeCheckpoint];
+}
+
+/**
+ Zeroes any bytes after offset so a torn record left by a crash can't be read
+ as a record once new records are written over the start of it. Pages that are
+ already zero are only read, so a mostly empty segment isn't dirtied.
+ */
+-(void)_zeroSegment:(CWQueueSegment *)segment fromOffset:(size_t)offset {
+	size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	while (offset < segment->_size) {
+		size_t pageEnd = MIN((offset & ~(pageSize - 1)) + pageSize, segment->_size);
+		const uint64_t *word = (const uint64_t *)(segment->_bytes + offset);
+		const uint64_t *end = (const uint64_t *)(segment->_bytes + pageEnd);
+		while (word < end && *word == 0) word++;
+		if (word < end) memset(segment->_bytes + offset, 0, pageEnd - offset);
+		offset = pageEnd;
+	}
+}
+
+#pragma mark Appending -
+
+-(BOOL)appendBytes:(const void *)bytes
+			length:(NSUInteger)length
+			  type:(uint8_t)type
+		  sequence:(uint64_t *)sequence {
+	NSData *record = [NSData dataWithBytesNoCopy:(void *)bytes length:length freeWhenDone:NO];
+	return [self appendRecords:@[ record ] types:&type lastSequence:sequence error:NULL];
+}
+
+-(BOOL)appendRecords:(NSArray *)records
+			   types:(const uint8_t *)types
+		lastSequence:(uint64_t *)sequence
+			   error:(NSError **)error {
+	NSUInteger count = records.count;
+	if (count == 0) return YES;
+	
+	//create every segment the records need before writing any of them, that
+	//is the only step that can fail so the records go in all or nothing
+	NSMutableArray *newSegments = nil;
+	uint64_t index = _writeSegment->_index;
+	size_t offset = _writeOffset;
+	size_t size = _writeSegment->_size;
+	for (NSUInteger i = 0; i < count; i++) {
+		NSUInteger length = [records[i] length];
+		CWAssert(types[i] != 0);
+		CWAssert(length <= UINT32_MAX);
+		size_t recordSize = CWQueueRecordSize(length);
+		if (offset + recordSize > size) {
+			CWQueueSegment *segment = [self _newSegmentAtIndex:++index
+												 firstSequence:_tailSequence + i
+													recordSize:recordSize
+														 error:error];
+			if (segment == nil) {
+				for (CWQueueSegment *unused in newSegments) {
+					unlink([self _pathForSegmentIndex:unused->_index].fileSystemRepresentation);
+				}
+				return NO;
+			}
+			if (newSegments == nil) newSegments = [NSMutableArray array];
+			[newSegments addObject:segment];
+			offset = sizeof(CWQueueSegmentHeader);
+			size = segment->_size;
+		}
+		offset += recordSize;
+	}
+	
+	NSUInteger nextSegment = 0;
+	for (NSUInteger i = 0; i < count; i++) {
+		NSData *data = records[i];
+		size_t recordSize = CWQueueRecordSize(data.length);
+		if (_writeOffset + recordSize > _writeSegment->_size) [self _moveWriteToSegment:newSegments[nextSegment++]];
+		
+		CWQueueRecordHeader *record = (CWQueueRecordHeader *)(_writeSegment->_bytes + _writeOffset);
+		memcpy(record + 1, data.bytes, data.length);
+		record->length = (uint32_t)data.length;
+		record->checksum = CWQueueRecordChecksum((uint32_t)data.length, types[i], data.bytes);
+		record->type = types[i];
+		
+		CWLockLock(&_stateLock);
+		_writeOffset += recordSize;
+		_tailSequence++;
+		CWLockUnlock(&_stateLock);
+	}
+	
+	if (sequence) *sequence = _tailSequence - 1;
+	return YES;
+}
+
+/**
+ Creates the segment file at index, big enough for a record of recordSize bytes
+ */
+-(CWQueueSegment *)_newSegmentAtIndex:(uint64_t)index
+						firstSequence:(uint64_t)firstSequence
+						   recordSize:(size_t)recordSize
+								error:(NSError **)error {
+	size_t size = MAX((size_t)self.segmentSize, sizeof(CWQueueSegmentHeader) + recordSize);
+	return [[CWQueueSegment alloc] initWithPath:[self _pathForSegmentIndex:index]
+										  index:index
+								  firstSequence:firstSequence
+										   size:size
+										  error:error];
+}
+
+/**
+ Makes segment the one being appended to. The full segment is handed to the
+ syncing thread, or with CWQueueSyncPolicyNone to the OS to start writing back.
+ */
+-(void)_moveWriteToSegment:(CWQueueSegment *)segment {
+	CWLockLock(&_stateLock);
+	CWQueueSegment *fullSegment = _writeSegment;
+	fullSegment->_endOffset = _writeOffset;
+	if (self.syncPolicy != CWQueueSyncPolicyNone) {
+		[_unsyncedSegments addObject:fullSegment];
+	} else {
+		//nothing syncs on its own with this policy, so rather than hold on to
+		//every full segment -sync finds them by index
+		_unsyncedEndIndex = segment->_index;
+	}
+	_writeSegment = segment;
+	_writeOffset = sizeof(CWQueueSegmentHeader);
+	_directoryChanged = YES;
+	CWLockUnlock(&_stateLock);
+	
+	if (self.syncPolicy == CWQueueSyncPolicyNone) {
+		msync(fullSegment->_bytes, fullSegment->_endOffset, MS_ASYNC);
+	}
+}
+
+#pragma mark Consuming -
+
+-(NSUInteger)count {
+	return (NSUInteger)(_tailSequence - _headSequence);
+}
+
+/**
+ Moves the read position on to the next segment if it is at the end of the
+ current one, deleting the segment it leaves. Returns the head record or NULL
+ if the log is empty.
+ 
+ A corrupt record ends its segment, since the records after it can't be found
+ without trusting its length, and the records skipped that way are discarded.
+ */
+-(CWQueueRecordHeader *)_headRecord {
+	while (_headSequence < _tailSequence) {
+		if (_validatedHeadRecord) return _validatedHeadRecord;
+		
+		CWQueueRecordHeader *record = NULL;
+		CWQueueRecordStatus status = [_readSegment recordAtOffset:_readOffset record:&record];
+		if (status == CWQueueRecordStatusValid) {
+			_validatedHeadRecord = record;
+			return record;
+		}
+		if (_readSegment == _writeSegment) {
+			//nothing comes after the segment being appended to
+			uint64_t lost = _tailSequence - _headSequence;
+			_discardedRecordCount += lost;
+			_lastError = [self _errorForSegmentIndex:_readSegment->_index
+										 description:[NSString stringWithFormat:@"%llu records were lost to a damaged record",
+													  (unsigned long long)lost]];
+			_readOffset = _writeOffset;
+			_headSequence = _tailSequence;
+			[self _writeCheckpoint];
+			return NULL;
+		}
+		
+		uint64_t consumedIndex = _readSegment->_index;
+		[self _moveHeadToSegment:[self _segmentAfterIndex:consumedIndex minimumSequence:_headSequence]];
+		//also removes any damaged segments that were skipped
+		for (uint64_t index = consumedIndex; index < _readSegment->_index; index++) {
+			unlink([self _pathForSegmentIndex:index].fileSystemRepresentation);
+		}
+	}
+	return NULL;
+}
+
+-(BOOL)readHeadRecordUsingBlock:(void (^)(const void *bytes, NSUInteger length, uint8_t type))block {
+	CWQueueRecordHeader *record = [self _headRecord];
+	if (record == NULL) return NO;
+	block(record + 1, record->length, record->type);
+	return YES;
+}
+
+-(BOOL)advanceHead {
+	CWQueueRecordHeader *record = [self _headRecord];
+	if (record == NULL) return NO;
+	_readOffset += CWQueueRecordSize(record->length);
+	_headSequence++;
+	_validatedHeadRecord = NULL;
+	[self _writeCheckpoint];
+	return YES;
+}
+
+-(BOOL)discardHeadRecordForReason:(NSError *)reason {
+	if (![self advanceHead]) return NO;
+	_discardedRecordCount++;
+	_lastError = reason;
+	return YES;
+}
+
+-(void)enumerateRecordsUsingBlock:(void (^)(const void *bytes, NSUInteger length, uint8_t type, BOOL *stop))block {
+	[self enumerateRecordsBeforeSequence:_tailSequence usingBlock:block];
+}
+
+-(void)enumerateRecordsBeforeSequence:(uint64_t)endSequence
+						   usingBlock:(void (^)(const void *bytes, NSUInteger length, uint8_t type, BOOL *stop))block {
+	CWQueueSegment *segment = _readSegment;
+	size_t offset = _readOffset;
+	uint64_t sequence = _headSequence;
+	endSequence = MIN(endSequence, _tailSequence);
+	BOOL stop = NO;
+	while (sequence < endSequence && !stop) {
+		CWQueueRecordHeader *record = NULL;
+		if ([segment recordAtOffset:offset record:&record] != CWQueueRecordStatusValid) {
+			//skip what -_headRecord would skip, without discarding anything
+			if (segment == _writeSegment) break;
+			segment = [self _segmentAfterIndex:segment->_index minimumSequence:sequence];
+			offset = sizeof(CWQueueSegmentHeader);
+			sequence = MAX(sequence, segment->_firstSequence);
+			continue;
+		}
+		block(record + 1, record->length, record->type, &stop);
+		offset += CWQueueRecordSize(record->length);
+		sequence++;
+	}
+}
+
+-(void)removeAllRecords {
+	uint64_t firstIndex = _readSegment->_index;
+	_readSegment = _writeSegment;
+	_readOffset = _writeOffset;
+	_validatedHeadRecord = NULL;
+	_headSequence = _tailSequence;
+	[self _writeCheckpoint];
+	for (uint64_t index = firstIndex; index < _writeSegment->_index; index++) {
+		unlink([self _pathForSegmentIndex:index].fileSystemRepresentation);
+	}
+}
+
+/**
+ Writes the head position to the checkpoint slot not holding the last one
+ */
+-(void)_writeCheckpoint {
+	CWQueueCheckpoint checkpoint;
+	checkpoint.magic = kCWQueueCheckpointMagic;
+	checkpoint.generation = ++_checkpointGeneration;
+	checkpoint.segmentIndex = _readSegment->_index;
+	checkpoint.offset = _readOffset;
+	checkpoint.sequence = _headSequence;
+	checkpoint.checksum = CWQueueCheckpointChecksum(&checkpoint);
+	_checkpoints[checkpoint.generation % 2] = checkpoint;
+}
+
+#pragma mark Syncing -
+
+/**
+ Syncs everything appended so far & returns the tail sequence it covered.
+ Only one thread at a time calls this, see -syncThroughSequence:.
+ */
+-(uint64_t)_syncWrittenRecords {
+	CWLockLock(&_stateLock);
+	NSArray *fullSegments = (_unsyncedSegments.count > 0) ? [_unsyncedSegments copy] : nil;
+	[_unsyncedSegments removeAllObjects];
+	CWQueueSegment *segment = _writeSegment;
+	size_t offset = _writeOffset;
+	uint64_t tailSequence = _tailSequence;
+	BOOL directoryChanged = _directoryChanged;
+	_directoryChanged = NO;
+	uint64_t unsyncedIndex = _unsyncedFirstIndex;
+	uint64_t unsyncedEndIndex = _unsyncedEndIndex;
+	_unsyncedFirstIndex = _unsyncedEndIndex;
+	CWLockUnlock(&_stateLock);
+	
+	for (; unsyncedIndex < unsyncedEndIndex; unsyncedIndex++) {
+		//segments consumed in the meantime are gone & don't need syncing
+		int fd = open([self _pathForSegmentIndex:unsyncedIndex].fileSystemRepresentation, O_RDONLY);
+		if (fd < 0) continue;
+		fsync(fd);
+		close(fd);
+	}
+	for (CWQueueSegment *fullSegment in fullSegments) {
+		[fullSegment syncThroughOffset:fullSegment->_endOffset];
+	}
+	[segment syncThroughOffset:offset];
+	if (directoryChanged) fsync(_directoryFD);
+	msync(_checkpoints, (size_t)sysconf(_SC_PAGESIZE), MS_SYNC);
+	return tailSequence;
+}
+
+/**
+ Group commit: the first thread to need a sync runs it while later threads
+ wait for it to finish, then only sync again if it didn't cover them. force
+ makes sure a sync starts after this call, for -sync which also needs the
+ current checkpoint on disk.
+ */
+-(void)_syncThroughSequence:(uint64_t)sequence force:(BOOL)force {
+	pthread_mutex_lock(&_syncMutex);
+	while (force || _durableSequence < sequence) {
+		if (_syncing) {
+			pthread_cond_wait(&_syncCondition, &_syncMutex);
+			continue;
+		}
+		_syncing = YES;
+		force = NO;
+		pthread_mutex_unlock(&_syncMutex);
+		uint64_t synced = [self _syncWrittenRecords];
+		pthread_mutex_lock(&_syncMutex);
+		_syncing = NO;
+		if (synced > _durableSequence) _durableSequence = synced;
+		pthread_cond_broadcast(&_syncCondition);
+	}
+	pthread_mutex_unlock(&_syncMutex);
+}
+
+-(void)syncThroughSequence:(uint64_t)sequence {
+	[self _syncThroughSequence:sequence force:NO];
+}
+
+-(void)sync {
+	CWLockLock(&_stateLock);
+	uint64_t tailSequence = _tailSequence;
+	CWLockUnlock(&_stateLock);
+	[self _syncThroughSequence:tailSequence force:YES];
+}
+
+@end
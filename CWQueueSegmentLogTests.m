@@ -0,0 +1,349 @@
+/*
+//  CWQueueSegmentLogTests.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWQueueSegmentLog.h"
+
+static NSString *CWQueueSegmentLogTestDirectory(void) {
+	NSString *name = [NSString stringWithFormat:@"CWQueueSegmentLogTests-%@", [[NSUUID UUID] UUIDString]];
+	return [NSTemporaryDirectory() stringByAppendingPathComponent:name];
+}
+
+static CWQueueSegmentLog *CWQueueSegmentLogTestOpen(NSString *directory, NSUInteger segmentSize) {
+	return [[CWQueueSegmentLog alloc] initWithDirectory:directory
+											segmentSize:segmentSize
+											 syncPolicy:CWQueueSyncPolicyNone
+												  error:NULL];
+}
+
+static void CWQueueSegmentLogTestAppend(CWQueueSegmentLog *log, NSString *string) {
+	NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+	[log appendBytes:data.bytes length:data.length type:1 sequence:NULL];
+}
+
+static NSString *CWQueueSegmentLogTestHead(CWQueueSegmentLog *log) {
+	__block NSString *string = nil;
+	[log readHeadRecordUsingBlock:^(const void *bytes, NSUInteger length, uint8_t type) {
+		string = [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+	}];
+	return string;
+}
+
+SpecBegin(CWQueueSegmentLog)
+
+describe(@"appending & consuming", ^{
+	it(@"should hand out records in the order they were appended", ^{
+		NSString *directory = CWQueueSegmentLogTestDirectory();
+		CWQueueSegmentLog *log = CWQueueSegmentLogTestOpen(directory, kCWQueueSegmentLogDefaultSegmentSize);
+		
+		expect(log).notTo.beNil();
+		expect(log.count == 0).to.beTruthy();
+		
+		uint64_t sequence = 0;
+		NSData *data = [@"Fry" dataUsingEncoding:NSUTF8StringEncoding];
+		expect([log appendBytes:data.bytes length:data.length type:7 sequence:&sequence]).to.beTruthy();
+		expect(sequence == 0).to.beTruthy();
+		CWQueueSegmentLogTestAppend(log, @"Leela");
+		
+		__block uint8_t headType = 0;
+		[log readHeadRecordUsingBlock:^(const void *bytes, NSUInteger length, uint8_t type) {
+			headType = type;
+		}];
+		expect(headType == 7).to.beTruthy();
+		expect(CWQueueSegmentLogTestHead(log)).to.equal(@"Fry");
+		expect([log advanceHead]).to.beTruthy();
+		expect(CWQueueSegmentLogTestHead(log)).to.equal(@"Leela");
+		expect([log advanceHead]).to.beTruthy();
+		expect([log advanceHead]).to.beFalsy();
+		expect(log.headSequence == 2).to.beTruthy();
+		
+		[[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+	});
+	
+	it(@"should enumerate records without consuming them", ^{
+		NSString *directory = CWQueueSegmentLogTestDirectory();
+		CWQueueSegmentLog *log = CWQueueSegmentLogTestOpen(directory, kCWQueueSegmentLogDefaultSegmentSize);
+		CWQueueSegmentLogTestAppend(log, @"Fry");
+		CWQueueSegmentLogTestAppend(log, @"Leela");
+		CWQueueSegmentLogTestAppend(log, @"Bender");
+		[log advanceHead];
+		
+		NSMutableArray *strings = [NSMutableArray array];
+		[log enumerateRecordsUsingBlock:^(const void *bytes, NSUInteger length, uint8_t type, BOOL *stop) {
+			[strings addObject:[[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding]];
+		}];
+		
+		expect(strings).to.equal(@[ @"Leela", @"Bender" ]);
+		expect(log.count == 2).to.beTruthy();
+		
+		[[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+	});
+});
+
+describe(@"recovery", ^{
+	it(@"should recover unconsumed records when reopened", ^{
+		NSString *directory = CWQueueSegmentLogTestDirectory();
+		@autoreleasepool {
+			CWQueueSegmentLog *log = CWQueueSegmentLogTestOpen(directory, kCWQueueSegmentLogDefaultSegmentSize);
+			CWQueueSegmentLogTestAppend(log, @"Fry");
+			CWQueueSegmentLogTestAppend(log, @"Leela");
+			CWQueueSegmentLogTestAppend(log, @"Bender");
+			[log advanceHead];
+		}
+		
+		CWQueueSegmentLog *log = CWQueueSegmentLogTestOpen(directory, kCWQueueSegmentLogDefaultSegmentSize);
+		expect(log.count == 2).to.beTruthy();
+		expect(log.headSequence == 1).to.beTruthy();
+		expect(log.tailSequence == 3).to.beTruthy();
+		expect(CWQueueSegmentLogTestHead(log)).to.equal(@"Leela");
+		
+		[[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+	});
+	
+	it(@"should drop a torn record at the tail", ^{
+		NSString *directory = CWQueueSegmentLogTestDirectory();
+		@autoreleasepool {
+			CWQueueSegmentLog *log = CWQueueSegmentLogTestOpen(directory, kCWQueueSegmentLogDefaultSegmentSize);
+			CWQueueSegmentLogTestAppend(log, @"Fry");
+			CWQueueSegmentLogTestAppend(log, @"Leela");
+		}
+		
+		//scribble over the last records bytes as if the crash tore its write
+		NSString *segment = nil;
+		for (NSString *name in [[NSFileManager defaultManager] contentsOfDirectoryAtPath:directory error:NULL]) {
+			if ([name.pathExtension isEqualToString:@"segment"]) segment = [directory stringByAppendingPathComponent:name];
+		}
+		NSData *contents = [NSData dataWithContentsOfFile:segment];
+		NSRange range = [contents rangeOfData:[@"Leela" dataUsingEncoding:NSUTF8StringEncoding]
+									  options:0
+										range:NSMakeRange(0, contents.length)];
+		expect(range.location != NSNotFound).to.beTruthy();
+		NSFileHandle *handle = [NSFileHandle fileHandleForWritingAtPath:segment];
+		[handle seekToFileOffset:range.location];
+		[handle writeData:[@"Zoidb" dataUsingEncoding:NSUTF8StringEncoding]];
+		[handle closeFile];
+		
+		CWQueueSegmentLog *log = CWQueueSegmentLogTestOpen(directory, kCWQueueSegmentLogDefaultSegmentSize);
+		expect(log.count == 1).to.beTruthy();
+		expect(CWQueueSegmentLogTestHead(log)).to.equal(@"Fry");
+		CWQueueSegmentLogTestAppend(log, @"Bender");
+		[log advanceHead];
+		expect(CWQueueSegmentLogTestHead(log)).to.equal(@"Bender");
+		
+		[[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+	});
+});
+
+describe(@"segments", ^{
+	it(@"should start new segments & delete them once consumed", ^{
+		NSString *directory = CWQueueSegmentLogTestDirectory();
+		CWQueueSegmentLog *log = CWQueueSegmentLogTestOpen(directory, 64 * 1024);
+		NSMutableData *record = [NSMutableData dataWithLength:4096];
+		for (NSUInteger i = 0; i < 100; i++) {
+			[log appendBytes:record.bytes length:record.length type:1 sequence:NULL];
+		}
+		//records bigger than a segment get a segment of their own
+		NSMutableData *bigRecord = [NSMutableData dataWithLength:128 * 1024];
+		[log appendBytes:bigRecord.bytes length:bigRecord.length type:2 sequence:NULL];
+		CWQueueSegmentLogTestAppend(log, @"Fry");
+		
+		NSArray *(^segments)(void) = ^NSArray *{
+			NSArray *names = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:directory error:NULL];
+			return [names filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"pathExtension == 'segment'"]];
+		};
+		expect(segments().count > 2).to.beTruthy();
+		
+		for (NSUInteger i = 0; i < 101; i++) [log advanceHead];
+		expect(CWQueueSegmentLogTestHead(log)).to.equal(@"Fry");
+		expect(segments().count == 1).to.beTruthy();
+		
+		[[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+	});
+	
+	it(@"should append all of a batch or none of it", ^{
+		NSString *directory = CWQueueSegmentLogTestDirectory();
+		CWQueueSegmentLog *log = CWQueueSegmentLogTestOpen(directory, 64 * 1024);
+		NSMutableArray *records = [NSMutableArray array];
+		uint8_t types[100];
+		for (NSUInteger i = 0; i < 100; i++) {
+			[records addObject:[NSMutableData dataWithLength:1024]];
+			types[i] = 1;
+		}
+		//a file in the way of the second segment makes starting it fail
+		NSString *blocker = [directory stringByAppendingPathComponent:@"0000000000000001.segment"];
+		[[NSData data] writeToFile:blocker atomically:NO];
+		
+		NSError *error = nil;
+		expect([log appendRecords:records types:types lastSequence:NULL error:&error]).to.beFalsy();
+		expect(error).notTo.beNil();
+		expect(log.count == 0).to.beTruthy();
+		
+		[[NSFileManager defaultManager] removeItemAtPath:blocker error:NULL];
+		uint64_t sequence = 0;
+		expect([log appendRecords:records types:types lastSequence:&sequence error:NULL]).to.beTruthy();
+		expect(log.count == 100).to.beTruthy();
+		expect(sequence == 99).to.beTruthy();
+		
+		[[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+	});
+});
+
+describe(@"damaged segments", ^{
+	/**
+	 fills segments of 64 KB with 1 KB records each holding their number, with
+	 record headers & padding every segment but the last holds 62 records
+	 */
+	NSString *(^fill)(NSUInteger) = ^NSString *(NSUInteger count) {
+		NSString *directory = CWQueueSegmentLogTestDirectory();
+		@autoreleasepool {
+			CWQueueSegmentLog *log = CWQueueSegmentLogTestOpen(directory, 64 * 1024);
+			NSMutableData *record = [NSMutableData dataWithLength:1024];
+			for (uint64_t i = 0; i < count; i++) {
+				memcpy(record.mutableBytes, &i, sizeof(i));
+				[log appendBytes:record.bytes length:record.length type:1 sequence:NULL];
+			}
+		}
+		return directory;
+	};
+	NSString *(^segmentPath)(NSString *, uint64_t) = ^NSString *(NSString *directory, uint64_t index) {
+		return [directory stringByAppendingPathComponent:[NSString stringWithFormat:@"%016llx.segment", (unsigned long long)index]];
+	};
+	NSArray *(^drain)(CWQueueSegmentLog *) = ^NSArray *(CWQueueSegmentLog *log) {
+		NSMutableArray *numbers = [NSMutableArray array];
+		while ([log readHeadRecordUsingBlock:^(const void *bytes, NSUInteger length, uint8_t type) {
+			uint64_t number = 0;
+			memcpy(&number, bytes, sizeof(number));
+			[numbers addObject:@(number)];
+		}]) {
+			[log advanceHead];
+		}
+		return numbers;
+	};
+	
+	it(@"should skip the rest of a segment after a corrupt record", ^{
+		NSString *directory = fill(300);
+		//flip a byte in the 11th record of the second segment
+		NSString *path = segmentPath(directory, 1);
+		NSMutableData *contents = [NSMutableData dataWithContentsOfFile:path];
+		((uint8_t *)contents.mutableBytes)[32 + (10 * 1040) + 16 + 100] ^= 0xFF;
+		[contents writeToFile:path atomically:NO];
+		
+		CWQueueSegmentLog *log = CWQueueSegmentLogTestOpen(directory, 64 * 1024);
+		NSMutableArray *enumerated = [NSMutableArray array];
+		[log enumerateRecordsUsingBlock:^(const void *bytes, NSUInteger length, uint8_t type, BOOL *stop) {
+			uint64_t number = 0;
+			memcpy(&number, bytes, sizeof(number));
+			[enumerated addObject:@(number)];
+		}];
+		NSArray *numbers = drain(log);
+		
+		expect(numbers).to.equal(enumerated);
+		expect(numbers.count + log.discardedRecordCount == 300).to.beTruthy();
+		expect(log.discardedRecordCount == 62 - 10).to.beTruthy();
+		expect(numbers[72]).to.equal(@124);
+		expect(log.lastError).notTo.beNil();
+		
+		[[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+	});
+	
+	it(@"should report a missing segment & skip its records", ^{
+		NSString *directory = fill(300);
+		[[NSFileManager defaultManager] removeItemAtPath:segmentPath(directory, 2) error:NULL];
+		
+		CWQueueSegmentLog *log = CWQueueSegmentLogTestOpen(directory, 64 * 1024);
+		expect(log).notTo.beNil();
+		expect(log.lastError).notTo.beNil();
+		
+		NSArray *numbers = drain(log);
+		expect(numbers.count == 300 - 62).to.beTruthy();
+		expect(numbers[124]).to.equal(@186);
+		expect(log.discardedRecordCount == 62).to.beTruthy();
+		
+		[[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+	});
+	
+	it(@"should count records the owner discards", ^{
+		NSString *directory = CWQueueSegmentLogTestDirectory();
+		CWQueueSegmentLog *log = CWQueueSegmentLogTestOpen(directory, kCWQueueSegmentLogDefaultSegmentSize);
+		CWQueueSegmentLogTestAppend(log, @"Fry");
+		CWQueueSegmentLogTestAppend(log, @"Leela");
+		NSError *reason = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileReadCorruptFileError userInfo:nil];
+		
+		expect([log discardHeadRecordForReason:reason]).to.beTruthy();
+		expect(log.discardedRecordCount == 1).to.beTruthy();
+		expect(log.lastError).to.equal(reason);
+		expect(CWQueueSegmentLogTestHead(log)).to.equal(@"Leela");
+		
+		[[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+	});
+});
+
+describe(@"-syncThroughSequence", ^{
+	it(@"should let concurrent appenders share syncs", ^{
+		NSString *directory = CWQueueSegmentLogTestDirectory();
+		CWQueueSegmentLog *log = [[CWQueueSegmentLog alloc] initWithDirectory:directory
+																  segmentSize:64 * 1024
+																   syncPolicy:CWQueueSyncPolicyEveryWrite
+																		error:NULL];
+		NSLock *appendLock = [NSLock new];
+		dispatch_apply(200, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+			uint64_t sequence = 0;
+			[appendLock lock];
+			[log appendBytes:&i length:sizeof(i) type:1 sequence:&sequence];
+			[appendLock unlock];
+			[log syncThroughSequence:sequence + 1];
+		});
+		
+		expect(log.count == 200).to.beTruthy();
+		
+		[[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+	});
+	
+	it(@"should sync full & recovered segments with CWQueueSyncPolicyNone", ^{
+		NSString *directory = CWQueueSegmentLogTestDirectory();
+		NSMutableData *record = [NSMutableData dataWithLength:4096];
+		@autoreleasepool {
+			CWQueueSegmentLog *log = CWQueueSegmentLogTestOpen(directory, 64 * 1024);
+			for (NSUInteger i = 0; i < 100; i++) [log appendBytes:record.bytes length:record.length type:1 sequence:NULL];
+			[log advanceHead];
+			[log sync];
+			for (NSUInteger i = 0; i < 100; i++) [log appendBytes:record.bytes length:record.length type:1 sequence:NULL];
+		}
+		
+		CWQueueSegmentLog *log = CWQueueSegmentLogTestOpen(directory, 64 * 1024);
+		[log sync];
+		expect(log.count == 199).to.beTruthy();
+		
+		[[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+	});
+});
+
+SpecEnd
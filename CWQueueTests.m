@@ -216,6 +216,62 @@ describe(@"-enumerateObjectsInQueue", ^{
 	});
 });
 
+describe(@"fast enumeration", ^{
+	it(@"should enumerate objects in order with for...in", ^{
+		NSArray *objects = @[ @"1",@"2",@"3",@"4",@"5" ];
+		CWQueue *queue = [[CWQueue alloc] initWithObjectsFromArray:objects];
+		
+		NSMutableArray *results = [NSMutableArray array];
+		for (id object in queue) {
+			[results addObject:object];
+		}
+		
+		expect(results).to.equal(objects);
+	});
+	
+	it(@"should enumerate objects across multiple chunks", ^{
+		NSMutableArray *objects = [NSMutableArray array];
+		for (NSUInteger i = 0; i < 1000; i++) [objects addObject:@(i)];
+		CWQueue *queue = [[CWQueue alloc] initWithObjectsFromArray:objects];
+		CWQueue *unsynchronizedQueue = [[CWQueue alloc] initWithSynchronization:NO];
+		[unsynchronizedQueue enqueueObjectsFromArray:objects];
+		
+		NSMutableArray *results = [NSMutableArray array];
+		for (id object in queue) [results addObject:object];
+		expect(results).to.equal(objects);
+		
+		[results removeAllObjects];
+		for (id object in unsynchronizedQueue) [results addObject:object];
+		expect(results).to.equal(objects);
+	});
+	
+	it(@"should enumerate a snapshot when synchronized", ^{
+		CWQueue *queue = [[CWQueue alloc] initWithObjectsFromArray:@[ @"Fry",@"Leela",@"Bender" ]];
+		
+		NSMutableArray *results = [NSMutableArray array];
+		for (id object in queue) {
+			[results addObject:object];
+			[queue dequeue];
+			[queue enqueue:@"Zoidberg"];
+		}
+		
+		expect(results).to.equal(@[ @"Fry",@"Leela",@"Bender" ]);
+		expect(queue.count == 3).to.beTruthy();
+		expect([queue peek]).to.equal(@"Zoidberg");
+	});
+	
+	it(@"should raise when mutated during enumeration when unsynchronized", ^{
+		CWQueue *queue = [[CWQueue alloc] initWithSynchronization:NO];
+		[queue enqueueObjectsFromArray:@[ @"Fry",@"Leela",@"Bender" ]];
+		
+		expect(^{
+			for (id object in queue) {
+				[queue enqueue:object];
+			}
+		}).to.raiseAny();
+	});
+});
+
 describe(@"-enqueue", ^{
 	it(@"shoudn't enqueue nil", ^{
 		CWQueue *queue = [[CWQueue alloc] init];
@@ -266,6 +322,189 @@ describe(@"-isEqualToQueue", ^{
 	});
 });
 
+describe(@"-initWithDirectory:syncPolicy:error:", ^{
+	NSString *(^newDirectory)(void) = ^NSString *{
+		NSString *name = [NSString stringWithFormat:@"CWQueueTests-%@", [[NSUUID UUID] UUIDString]];
+		return [NSTemporaryDirectory() stringByAppendingPathComponent:name];
+	};
+	
+	it(@"should keep enqueued objects across queue instances", ^{
+		NSString *directory = newDirectory();
+		NSData *data = [@"Slurm" dataUsingEncoding:NSUTF8StringEncoding];
+		@autoreleasepool {
+			CWQueue *queue = [[CWQueue alloc] initWithDirectory:directory syncPolicy:CWQueueSyncPolicyEveryWrite error:NULL];
+			expect(queue.isDurable).to.beTruthy();
+			expect(queue.isSynchronized).to.beTruthy();
+			[queue enqueue:@"Fry"];
+			[queue enqueueObjectsFromArray:@[ data, @42, @{ @"Planet" : @"Express" } ]];
+			expect([queue dequeue]).to.equal(@"Fry");
+		}
+		
+		CWQueue *queue = [[CWQueue alloc] initWithDirectory:directory syncPolicy:CWQueueSyncPolicyEveryWrite error:NULL];
+		expect(queue.count == 3).to.beTruthy();
+		expect([queue peek]).to.equal(data);
+		expect([queue containsObject:@42]).to.beTruthy();
+		expect([queue dequeue]).to.equal(data);
+		expect([queue dequeue]).to.equal(@42);
+		expect([queue dequeue]).to.equal(@{ @"Planet" : @"Express" });
+		expect([queue dequeue]).to.beNil();
+		
+		[[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+	});
+	
+	it(@"should keep order when the queue is longer than it keeps in memory", ^{
+		NSString *directory = newDirectory();
+		NSUInteger total = 20000;
+		@autoreleasepool {
+			CWQueue *queue = [[CWQueue alloc] initWithDirectory:directory syncPolicy:CWQueueSyncPolicyNone error:NULL];
+			for (NSUInteger i = 0; i < total / 2; i++) [queue enqueue:[NSString stringWithFormat:@"%lu", (unsigned long)i]];
+		}
+		
+		CWQueue *queue = [[CWQueue alloc] initWithDirectory:directory syncPolicy:CWQueueSyncPolicyNone error:NULL];
+		for (NSUInteger i = total / 2; i < total; i++) [queue enqueue:[NSString stringWithFormat:@"%lu", (unsigned long)i]];
+		expect(queue.count == total).to.beTruthy();
+		
+		NSUInteger index = 0;
+		for (id object in queue) {
+			if (index == 0 || index == total - 1) expect(object).to.equal([NSString stringWithFormat:@"%lu", (unsigned long)index]);
+			index++;
+		}
+		expect(index == total).to.beTruthy();
+		
+		BOOL inOrder = YES;
+		for (NSUInteger i = 0; i < total; i++) {
+			if (![[queue dequeue] isEqual:[NSString stringWithFormat:@"%lu", (unsigned long)i]]) inOrder = NO;
+		}
+		expect(inOrder).to.beTruthy();
+		expect(queue.isEmpty).to.beTruthy();
+		
+		[[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+	});
+	
+	it(@"should not recover objects that were removed", ^{
+		NSString *directory = newDirectory();
+		@autoreleasepool {
+			CWQueue *queue = [[CWQueue alloc] initWithDirectory:directory syncPolicy:CWQueueSyncPolicyInterval error:NULL];
+			[queue enqueueObjectsFromArray:@[ @"Fry", @"Leela" ]];
+			[queue removeAllObjects];
+			[queue enqueue:@"Bender"];
+			[queue sync];
+		}
+		
+		CWQueue *queue = [[CWQueue alloc] initWithDirectory:directory syncPolicy:CWQueueSyncPolicyInterval error:NULL];
+		expect(queue.count == 1).to.beTruthy();
+		expect([queue dequeue]).to.equal(@"Bender");
+		
+		[[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+	});
+	
+	it(@"should stop decoding the backlog once a search finds a match", ^{
+		NSString *directory = newDirectory();
+		@autoreleasepool {
+			CWQueue *queue = [[CWQueue alloc] initWithDirectory:directory syncPolicy:CWQueueSyncPolicyNone error:NULL];
+			for (NSUInteger i = 0; i < 100; i++) [queue enqueue:[NSString stringWithFormat:@"%lu", (unsigned long)i]];
+		}
+		
+		//after a restart the whole backlog is only in the log
+		CWQueue *queue = [[CWQueue alloc] initWithDirectory:directory syncPolicy:CWQueueSyncPolicyNone error:NULL];
+		[queue enqueue:@"Fry"];
+		__block NSUInteger calls = 0;
+		BOOL found = [queue containsObjectWithBlock:^BOOL(id obj) {
+			calls++;
+			return [obj isEqual:@"2"];
+		}];
+		expect(found).to.beTruthy();
+		expect(calls == 3).to.beTruthy();
+		
+		NSMutableArray *enumerated = [NSMutableArray array];
+		[queue enumerateObjectsInQueue:^(id object, BOOL *stop) {
+			[enumerated addObject:object];
+			if (enumerated.count == 5) *stop = YES;
+		}];
+		expect(enumerated).to.equal((@[ @"0", @"1", @"2", @"3", @"4" ]));
+		
+		expect([queue containsObject:@"Fry"]).to.beTruthy();
+		expect([queue containsObject:@"Leela"]).to.beFalsy();
+		
+		NSMutableArray *all = [NSMutableArray array];
+		for (id object in queue) [all addObject:object];
+		expect(all.count == 101).to.beTruthy();
+		CWQueue *copy = [[CWQueue alloc] initWithObjectsFromArray:all];
+		expect([queue isEqualToQueue:copy]).to.beTruthy();
+		[copy dequeue];
+		expect([queue isEqualToQueue:copy]).to.beFalsy();
+		
+		[[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+	});
+	
+	it(@"should skip objects it can't decode", ^{
+		NSString *directory = newDirectory();
+		@autoreleasepool {
+			CWQueueSegmentLog *log = [[CWQueueSegmentLog alloc] initWithDirectory:directory
+																	  segmentSize:kCWQueueSegmentLogDefaultSegmentSize
+																	   syncPolicy:CWQueueSyncPolicyNone
+																			error:NULL];
+			//a string record that isn't UTF-8 & an archive record that isn't an archive
+			uint8_t garbage[] = { 0xFF, 0xFE, 0xFD };
+			[log appendBytes:garbage length:sizeof(garbage) type:2 sequence:NULL];
+			[log appendBytes:garbage length:sizeof(garbage) type:3 sequence:NULL];
+			NSData *leela = [@"Leela" dataUsingEncoding:NSUTF8StringEncoding];
+			[log appendBytes:leela.bytes length:leela.length type:2 sequence:NULL];
+		}
+		
+		CWQueue *queue = [[CWQueue alloc] initWithDirectory:directory syncPolicy:CWQueueSyncPolicyNone error:NULL];
+		expect(queue.lastError).to.beNil();
+		expect([queue peek]).to.equal(@"Leela");
+		expect(queue.discardedObjectCount == 2).to.beTruthy();
+		expect(queue.lastError).notTo.beNil();
+		expect([queue dequeue]).to.equal(@"Leela");
+		expect(queue.isEmpty).to.beTruthy();
+		
+		[[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+	});
+	
+	it(@"should enqueue all of a batch or none of it", ^{
+		NSString *directory = newDirectory();
+		CWQueue *queue = [[CWQueue alloc] initWithDirectory:directory syncPolicy:CWQueueSyncPolicyNone error:NULL];
+		//the second object is too big for the first segment
+		NSArray *objects = @[ @"Fry", [NSMutableData dataWithLength:kCWQueueSegmentLogDefaultSegmentSize] ];
+		//a file in the way of the logs second segment makes starting it fail
+		NSString *blocker = [directory stringByAppendingPathComponent:@"0000000000000001.segment"];
+		[[NSData data] writeToFile:blocker atomically:NO];
+		
+		NSError *error = nil;
+		expect([queue enqueueObjectsFromArray:objects error:&error]).to.beFalsy();
+		expect(error).notTo.beNil();
+		expect(queue.isEmpty).to.beTruthy();
+		expect(^{
+			[queue enqueueObjectsFromArray:objects];
+		}).to.raise(NSInternalInconsistencyException);
+		expect(queue.isEmpty).to.beTruthy();
+		
+		[[NSFileManager defaultManager] removeItemAtPath:blocker error:NULL];
+		expect([queue enqueue:@"Leela" error:NULL]).to.beTruthy();
+		expect([queue dequeue]).to.equal(@"Leela");
+		
+		[[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+	});
+});
+
+describe(@"-initWithSynchronization", ^{
+	it(@"should behave the same without synchronization", ^{
+		CWQueue *queue = [[CWQueue alloc] initWithSynchronization:NO];
+		
+		expect(queue.isSynchronized).to.beFalsy();
+		expect([CWQueue new].isSynchronized).to.beTruthy();
+		
+		[queue enqueue:@"Fry"];
+		[queue enqueue:@"Leela"];
+		
+		expect(queue.count == 2).to.beTruthy();
+		expect([queue dequeue]).to.equal(@"Fry");
+		expect([queue peek]).to.equal(@"Leela");
+	});
+});
+
 it(@"should serialize multithreaded access", ^{
 	CWQueue *queue = [[CWQueue alloc] init];
 	
@@ -287,4 +526,30 @@ it(@"should serialize multithreaded access", ^{
 	expect([queue containsObject:@"!"]).to.beTruthy();
 });
 
+#if CW_STATISTICS
+
+describe(@"-statistics", ^{
+	it(@"should count operations & the high water mark", ^{
+		CWQueue *queue = [[CWQueue alloc] initWithObjectsFromArray:@[ @"Fry" ]];
+		[queue enqueue:@"Leela"];
+		[queue enqueue:@"Bender"];
+		[queue peek];
+		[queue dequeue];
+		[queue dequeue];
+		[queue dequeue];
+		[queue dequeue];
+		
+		NSDictionary *statistics = queue.statistics;
+		expect(statistics[@"enqueueCount"]).to.equal(@2);
+		expect(statistics[@"dequeueCount"]).to.equal(@3);
+		expect(statistics[@"emptyDequeueCount"]).to.equal(@1);
+		expect(statistics[@"peekCount"]).to.equal(@1);
+		expect(statistics[@"highWaterCount"]).to.equal(@3);
+		expect(statistics[@"waitTime"][@"count"]).to.equal(@7);
+		expect([statistics[@"waitTime"][@"buckets"] count] == kCWStatisticsWaitBuckets).to.beTruthy();
+	});
+});
+
+#endif
+
 SpecEnd
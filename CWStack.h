@@ -39,9 +39,14 @@
 
 /**
  This class is thread safe
+ 
+ Every operation takes a lock embedded in the instance. Stacks that are only
+ ever used from one thread at a time can be created with
+ -initWithSynchronization:NO to skip locking entirely.
  */
 
 #import <Foundation/Foundation.h>
+#import "CWStatistics.h"
 
 /**
  If uncommented (defined) then this enables Stack Peeking or Subscript access to
@@ -50,7 +55,22 @@
  */
 #define CWSTACK_PEEKING 1
 
-@interface CWStack : NSObject
+@interface CWStack : NSObject <NSFastEnumeration>
+
+/**
+ Initializes an empty stack
+ 
+ @param synchronized if YES the stack locks around every operation & is safe
+ to use from multiple threads, this is what -init does. If NO the stack does
+ no locking & must only be used from one thread at a time.
+ @return an initialized CWStack object
+ */
+-(instancetype)initWithSynchronization:(BOOL)synchronized;
+
+/**
+ Returns if the stack was created with synchronization
+ */
+@property(readonly, getter=isSynchronized) BOOL synchronized;
 
 /**
  initializes a CWStack object with the content of the array passed in
@@ -176,6 +196,20 @@
  */
 -(BOOL)containsObjectWithBlock:(BOOL (^)(id object))block;
 
+/**
+ Fast enumeration over the stack, lets you use for...in on a CWStack
+ 
+ Objects are given out from the top of the stack to the bottom, the order they
+ would be popped in. For a synchronized stack the loop goes over a snapshot of
+ the stack taken when the loop starts, the loop body is free to push & pop on
+ the stack (from any thread) and that won't change what the loop sees. For an
+ unsynchronized stack the loop goes directly over the stacks storage and
+ pushing/popping during the loop raises an exception.
+ */
+-(NSUInteger)countByEnumeratingWithState:(NSFastEnumerationState *)state
+								 objects:(id __unsafe_unretained [])buffer
+								   count:(NSUInteger)len;
+
 /**
  returns if the stack is currently empty
  
@@ -189,4 +223,22 @@
  @return a NSInteger indicating how many objects are currently in the stack
  */
 -(NSInteger)count;
+
+#if CW_STATISTICS
+
+/**
+ Returns the statistics the stack has kept since it was created
+ 
+ The dictionary contains pushCount, popCount, emptyPopCount (calls to -pop on
+ an empty stack), peekCount (calls to -topOfStackObject), highWaterCount (the
+ most objects the stack has held at once) & waitTime, a histogram of the time
+ each call waited for the stack's lock. Only available when CW_STATISTICS is
+ set to 1.
+ 
+ @return a NSDictionary with the stack's statistics
+ */
+-(NSDictionary *)statistics;
+
+#endif
+
 @end
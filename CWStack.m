@@ -32,14 +32,31 @@
  */
 
 #import "CWStack.h"
-#import <libkern/OSAtomic.h>
+#import "CWLock.h"
 
-@interface CWStack()
+#if CW_STATISTICS
+typedef struct CWStackStatistics {
+	uint64_t pushCount;
+	uint64_t popCount;
+	uint64_t emptyPopCount;
+	uint64_t peekCount;
+	uint64_t highWaterCount;
+	CWStatisticsWaitHistogram wait;
+} CWStackStatistics;
+#endif
+
+@interface CWStack() {
+	CWLock _lock;
+	unsigned long _mutations;
+#if CW_STATISTICS
+	CWStackStatistics _statistics;
+#endif
+}
 @property(nonatomic, strong) NSMutableArray *dataStore;
-@property(nonatomic) dispatch_queue_t queue;
 @end
 
-static int64_t queueCounter = 0;
+#define CWStackLock() CWLockAcquire(&_lock, _synchronized, _statistics.wait)
+#define CWStackUnlock() CWLockRelease(&_lock, _synchronized)
 
 @implementation CWStack
 
@@ -49,48 +66,56 @@ static int64_t queueCounter = 0;
  @return a empty CWStack instance
  */
 - (instancetype)init {
-    self = [super init];
-    if (self == nil) return nil;
+    return [self initWithSynchronization:YES];
+}
+
+-(instancetype)initWithSynchronization:(BOOL)synchronized {
+	self = [super init];
+	if (self == nil) return nil;
 	
 	_dataStore = [[NSMutableArray alloc] init];
-	const char *label = [[NSString stringWithFormat:@"com.Zangetsu.CWStack_%lli",
-						  OSAtomicIncrement64(&queueCounter)] UTF8String];
-	_queue = dispatch_queue_create(label, DISPATCH_QUEUE_SERIAL);
+	_synchronized = synchronized;
+	CWLockInit(&_lock);
 	
-    return self;
+	return self;
 }
 
 -(instancetype)initWithObjectsFromArray:(NSArray *)objects {
-	self = [super init];
+	self = [self initWithSynchronization:YES];
 	if (self == nil) return nil;
 	
-	_dataStore = [[NSMutableArray alloc] init];
-	const char *label = [[NSString stringWithFormat:@"com.Zangetsu.CWStack_%lli",
-						  OSAtomicIncrement64(&queueCounter)] UTF8String];
-	_queue = dispatch_queue_create(label, DISPATCH_QUEUE_SERIAL);
 	if (objects.count > 0) [_dataStore addObjectsFromArray:objects];
+	CWStatisticsHighWater(_statistics.highWaterCount, _dataStore.count);
 	
 	return self;
 }
 
+-(void)dealloc {
+	CWLockDestroy(&_lock);
+}
+
 -(void)push:(id)object {
-	__typeof(self) __weak wself = self;
-	dispatch_async(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		if (object) [sself.dataStore addObject:object];
-	});
+	if (object == nil) return;
+	CWStackLock();
+	[self.dataStore addObject:object];
+	_mutations++;
+	CWStatisticsCount(_statistics.pushCount);
+	CWStatisticsHighWater(_statistics.highWaterCount, self.dataStore.count);
+	CWStackUnlock();
 }
 
 -(id)pop {
-	__block id object = nil;
-	__typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		if (sself.dataStore.count > 0) {
-			object = [sself.dataStore lastObject];
-			[sself.dataStore removeLastObject];
-		}
-	});
+	id object = nil;
+	CWStackLock();
+	if (self.dataStore.count > 0) {
+		CWStatisticsCount(_statistics.popCount);
+		object = [self.dataStore lastObject];
+		[self.dataStore removeLastObject];
+		_mutations++;
+	} else {
+		CWStatisticsCount(_statistics.emptyPopCount);
+	}
+	CWStackUnlock();
 	return object;
 }
 
@@ -121,80 +146,120 @@ static int64_t queueCounter = 0;
 }
 
 -(id)topOfStackObject {
-	__block id object = nil;
-	__typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		if(sself.dataStore.count == 0) return;
-		object = [sself.dataStore lastObject];
-	});
+	id object = nil;
+	CWStackLock();
+	CWStatisticsCount(_statistics.peekCount);
+	if (self.dataStore.count > 0) object = [self.dataStore lastObject];
+	CWStackUnlock();
 	return object;
 }
 
 #if CWSTACK_PEEKING
 
 -(id)objectAtIndexedSubscript:(NSUInteger)index {
-    __block id object;
-    __typeof(self) __weak wself = self;
-    dispatch_sync(self.queue, ^{
-        __typeof(wself) __strong sself = wself;
-        object = [sself.dataStore objectAtIndexedSubscript:index];
-    });
+    CWStackLock();
+    id object = [self.dataStore objectAtIndexedSubscript:index];
+    CWStackUnlock();
     return object;
 }
 
 #endif
 
 -(id)bottomOfStackObject {
-	__block id object = nil;
-	__typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		if (sself.dataStore.count == 0) return;
-		object = sself.dataStore[0];
-	});
+	id object = nil;
+	CWStackLock();
+	if (self.dataStore.count > 0) object = self.dataStore[0];
+	CWStackUnlock();
 	return object;
 }
 
 -(void)clearStack {
-	__typeof(self) __weak wself = self;
-	dispatch_async(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		[sself.dataStore removeAllObjects];
-	});
+	CWStackLock();
+	[self.dataStore removeAllObjects];
+	_mutations++;
+	CWStackUnlock();
 }
 
 -(BOOL)isEqualToStack:(CWStack *)aStack {
-	__block BOOL isEqual = NO;
-	__typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		isEqual = [aStack.dataStore isEqual:sself.dataStore];
-	});
+	if (aStack == nil) return NO;
+	//take aStacks objects under its own lock, never hold both locks at once
+	NSArray *otherObjects = [aStack _dataStoreSnapshot];
+	CWStackLock();
+	BOOL isEqual = [self.dataStore isEqualToArray:otherObjects];
+	CWStackUnlock();
 	return isEqual;
 }
 
+-(NSArray *)_dataStoreSnapshot {
+	CWStackLock();
+	NSArray *snapshot = [self.dataStore copy];
+	CWStackUnlock();
+	return snapshot;
+}
+
 -(BOOL)containsObject:(id)object {
-	__block BOOL contains = NO;
-	__typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		contains = [sself.dataStore containsObject:object];
-	});
+	CWStackLock();
+	BOOL contains = [self.dataStore containsObject:object];
+	CWStackUnlock();
 	return contains;
 }
 
 -(BOOL)containsObjectWithBlock:(BOOL (^)(id object))block {
-	__block BOOL contains = NO;
-	__typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		NSUInteger index = [sself.dataStore indexOfObjectPassingTest:^BOOL(id obj, NSUInteger idx, BOOL *stop) {
-			return block(obj);
-		}];
-		if (index != NSNotFound) contains = YES;
-	});
-	return contains;
+	CWStackLock();
+	NSUInteger index = [self.dataStore indexOfObjectPassingTest:^BOOL(id obj, NSUInteger idx, BOOL *stop) {
+		return block(obj);
+	}];
+	CWStackUnlock();
+	return (index != NSNotFound);
+}
+
+#pragma mark NSFastEnumeration -
+
+/**
+ The stack is enumerated from the top down, which is the reverse of dataStore's
+ order so we can't just hand enumeration off to dataStore. Instead objects are
+ copied out in chunks & reversed into the buffer. A synchronized stack takes a
+ snapshot under the lock on the first call (autoreleased so it lives as long as
+ the loop does) & reports a mutations value that never changes, unsynchronized
+ stacks read dataStore directly & report _mutations so the loop raises if the
+ stack is pushed/popped mid loop. extra[0] holds the array being enumerated,
+ extra[1] the snapshots mutations value & extra[2] the number of objects given
+ out so far.
+ */
+-(NSUInteger)countByEnumeratingWithState:(NSFastEnumerationState *)state
+								 objects:(id __unsafe_unretained [])buffer
+								   count:(NSUInteger)len {
+	if (state->state == 0) {
+		state->state = 1;
+		state->extra[1] = 0;
+		state->extra[2] = 0;
+		if (_synchronized) {
+			CWStackLock();
+			NSArray * __autoreleasing snapshot = [self.dataStore copy];
+			CWStackUnlock();
+			state->extra[0] = (unsigned long)(__bridge void *)snapshot;
+			state->mutationsPtr = &state->extra[1];
+		} else {
+			state->extra[0] = (unsigned long)(__bridge void *)self.dataStore;
+			state->mutationsPtr = &_mutations;
+		}
+	}
+	
+	NSArray *source = (__bridge NSArray *)(void *)state->extra[0];
+	NSUInteger given = state->extra[2];
+	NSUInteger count = source.count;
+	if (given >= count || len == 0) return 0;
+	
+	NSUInteger chunk = MIN(count - given, len);
+	[source getObjects:buffer range:NSMakeRange(count - given - chunk, chunk)];
+	for (NSUInteger low = 0, high = chunk - 1; low < high; low++, high--) {
+		id swap = buffer[low];
+		buffer[low] = buffer[high];
+		buffer[high] = swap;
+	}
+	state->itemsPtr = buffer;
+	state->extra[2] = given + chunk;
+	return chunk;
 }
 
 /**
@@ -203,33 +268,39 @@ static int64_t queueCounter = 0;
  @return a NSString object with the description of the stack contents
  */
 -(NSString *)description {
-	__block NSString *stackDescription = nil;
-	__typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		stackDescription = [sself.dataStore description];
-	});
+	CWStackLock();
+	NSString *stackDescription = [self.dataStore description];
+	CWStackUnlock();
 	return stackDescription;
 }
 
 -(BOOL)isEmpty {
-    __block BOOL empty;
-    __typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		empty = (sself.dataStore.count <= 0);
-	});
+	CWStackLock();
+	BOOL empty = (self.dataStore.count <= 0);
+	CWStackUnlock();
 	return empty;
 }
 
 -(NSInteger)count {
-    __block NSInteger theCount = 0;
-    __typeof(self) __weak wself = self;
-	dispatch_sync(self.queue, ^{
-		__typeof(wself) __strong sself = wself;
-		theCount = sself.dataStore.count;
-	});
+	CWStackLock();
+	NSInteger theCount = self.dataStore.count;
+	CWStackUnlock();
 	return theCount;
 }
 
+#if CW_STATISTICS
+
+#pragma mark Statistics -
+
+-(NSDictionary *)statistics {
+	return @{ @"pushCount" : @(CWStatisticsLoad(&_statistics.pushCount)),
+			  @"popCount" : @(CWStatisticsLoad(&_statistics.popCount)),
+			  @"emptyPopCount" : @(CWStatisticsLoad(&_statistics.emptyPopCount)),
+			  @"peekCount" : @(CWStatisticsLoad(&_statistics.peekCount)),
+			  @"highWaterCount" : @(CWStatisticsLoad(&_statistics.highWaterCount)),
+			  @"waitTime" : CWStatisticsWaitHistogramDictionary(&_statistics.wait) };
+}
+
+#endif
+
 @end
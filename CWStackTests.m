@@ -157,6 +157,25 @@ describe(@"-popToBottomOfStack", ^{
 	});
 });
 
+describe(@"-isEqualToStack", ^{
+	it(@"should compare two stacks from two threads at once without deadlocking", ^{
+		CWStack *stack1 = [[CWStack alloc] initWithObjectsFromArray:@[@"Fry",@"Leela"]];
+		CWStack *stack2 = [[CWStack alloc] initWithObjectsFromArray:@[@"Fry",@"Leela"]];
+		
+		__block NSUInteger equalCount = 0;
+		NSLock *lock = [NSLock new];
+		dispatch_apply(1000, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+			BOOL isEqual = (i % 2) ? [stack1 isEqualToStack:stack2] : [stack2 isEqualToStack:stack1];
+			[lock lock];
+			if (isEqual) equalCount++;
+			[lock unlock];
+		});
+		
+		expect(equalCount).to.equal(1000);
+		expect([stack1 isEqualToStack:nil]).to.beFalsy();
+	});
+});
+
 describe(@"-popToObject", ^{
 	it(@"should return nil for non existant objects", ^{
 		CWStack *stack = [[CWStack alloc] initWithObjectsFromArray:@[@"Bender"]];
@@ -206,6 +225,77 @@ describe(@"-containsObjectWithBlock", ^{
 	});
 });
 
+describe(@"fast enumeration", ^{
+	it(@"should enumerate from the top of the stack to the bottom", ^{
+		CWStack *stack = [[CWStack alloc] initWithObjectsFromArray:@[ @"1",@"2",@"3" ]];
+		
+		NSMutableArray *results = [NSMutableArray array];
+		for (id object in stack) {
+			[results addObject:object];
+		}
+		
+		expect(results).to.equal(@[ @"3",@"2",@"1" ]);
+	});
+	
+	it(@"should enumerate objects across multiple chunks", ^{
+		NSMutableArray *objects = [NSMutableArray array];
+		for (NSUInteger i = 0; i < 1000; i++) [objects addObject:@(i)];
+		NSArray *expected = [[objects reverseObjectEnumerator] allObjects];
+		CWStack *stack = [[CWStack alloc] initWithObjectsFromArray:objects];
+		CWStack *unsynchronizedStack = [[CWStack alloc] initWithSynchronization:NO];
+		for (id object in objects) [unsynchronizedStack push:object];
+		
+		NSMutableArray *results = [NSMutableArray array];
+		for (id object in stack) [results addObject:object];
+		expect(results).to.equal(expected);
+		
+		[results removeAllObjects];
+		for (id object in unsynchronizedStack) [results addObject:object];
+		expect(results).to.equal(expected);
+	});
+	
+	it(@"should enumerate a snapshot when synchronized", ^{
+		CWStack *stack = [[CWStack alloc] initWithObjectsFromArray:@[ @"Fry",@"Leela" ]];
+		
+		NSMutableArray *results = [NSMutableArray array];
+		for (id object in stack) {
+			[results addObject:object];
+			[stack push:@"Bender"];
+		}
+		
+		expect(results).to.equal(@[ @"Leela",@"Fry" ]);
+		expect(stack.count == 4).to.beTruthy();
+	});
+	
+	it(@"should raise when mutated during enumeration when unsynchronized", ^{
+		CWStack *stack = [[CWStack alloc] initWithSynchronization:NO];
+		[stack push:@"Fry"];
+		[stack push:@"Leela"];
+		
+		expect(^{
+			for (id object in stack) {
+				[stack pop];
+			}
+		}).to.raiseAny();
+	});
+});
+
+describe(@"-initWithSynchronization", ^{
+	it(@"should behave the same without synchronization", ^{
+		CWStack *stack = [[CWStack alloc] initWithSynchronization:NO];
+		
+		expect(stack.isSynchronized).to.beFalsy();
+		expect([CWStack new].isSynchronized).to.beTruthy();
+		
+		[stack push:@"Fry"];
+		[stack push:@"Leela"];
+		
+		expect(stack.count == 2).to.beTruthy();
+		expect([stack pop]).to.equal(@"Leela");
+		expect([stack topOfStackObject]).to.equal(@"Fry");
+	});
+});
+
 it(@"should be able to serialize work being done concurrently", ^{
 	CWStack *stack = [[CWStack alloc] init];
 
@@ -227,4 +317,28 @@ it(@"should be able to serialize work being done concurrently", ^{
 	expect([stack containsObject:@"3"]).to.beTruthy();
 });
 
+#if CW_STATISTICS
+
+describe(@"-statistics", ^{
+	it(@"should count operations & the high water mark", ^{
+		CWStack *stack = [[CWStack alloc] initWithObjectsFromArray:@[ @"Fry" ]];
+		[stack push:@"Leela"];
+		[stack push:@"Bender"];
+		[stack topOfStackObject];
+		[stack pop];
+		[stack pop];
+		[stack pop];
+		[stack pop];
+		
+		NSDictionary *statistics = stack.statistics;
+		expect(statistics[@"pushCount"]).to.equal(@2);
+		expect(statistics[@"popCount"]).to.equal(@3);
+		expect(statistics[@"emptyPopCount"]).to.equal(@1);
+		expect(statistics[@"peekCount"]).to.equal(@1);
+		expect(statistics[@"highWaterCount"]).to.equal(@3);
+	});
+});
+
+#endif
+
 SpecEnd
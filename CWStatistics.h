@@ -0,0 +1,134 @@
+/*
+//  CWStatistics.h
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+ /*
+ This class should not make any use of the Zangetsu Framework API's so it can
+ retain its independence and be used in other projects not making use of the
+ Zangetsu Framework.
+  */
+
+#import <Foundation/Foundation.h>
+#include <time.h>
+
+/**
+ If set to 1 the data structures keep per instance statistics which can be read
+ with their -statistics method. When 0 the counters & -statistics methods are
+ not compiled in at all. Define CW_STATISTICS=1 in your build settings to turn
+ them on without editing this file.
+ 1 = ON, 0 = OFF
+ */
+#ifndef CW_STATISTICS
+#define CW_STATISTICS 0
+#endif
+
+/**
+ Wait time histogram buckets. Bucket 0 counts waits shorter than 256ns, each
+ following bucket doubles the bound & the last bucket counts everything longer.
+ */
+#define kCWStatisticsWaitBuckets 16
+#define kCWStatisticsWaitFirstBucketShift 8
+
+typedef struct CWStatisticsWaitHistogram {
+	uint64_t count;
+	uint64_t totalNanoseconds;
+	uint64_t buckets[kCWStatisticsWaitBuckets];
+} CWStatisticsWaitHistogram;
+
+/*
+ Counters are updated with relaxed atomics. The synchronized classes update
+ them while they hold their lock so the updates never contend with each
+ other, the atomics only keep -statistics from reading torn values.
+ */
+
+static inline void CWStatisticsIncrement(uint64_t *counter) {
+	__atomic_fetch_add(counter, 1, __ATOMIC_RELAXED);
+}
+
+static inline void CWStatisticsAddValue(uint64_t *counter, uint64_t value) {
+	__atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+}
+
+static inline uint64_t CWStatisticsLoad(const uint64_t *counter) {
+	return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+
+static inline void CWStatisticsRecordHighWater(uint64_t *highWater, uint64_t value) {
+	uint64_t current = __atomic_load_n(highWater, __ATOMIC_RELAXED);
+	while (value > current) {
+		if (__atomic_compare_exchange_n(highWater, &current, value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+	}
+}
+
+static inline uint64_t CWStatisticsNow(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ Records the time since start in histogram
+ */
+static inline void CWStatisticsRecordWait(CWStatisticsWaitHistogram *histogram, uint64_t start) {
+	uint64_t elapsed = CWStatisticsNow() - start;
+	NSUInteger bucket = 0;
+	uint64_t bound = elapsed >> kCWStatisticsWaitFirstBucketShift;
+	while (bound > 0 && bucket < (kCWStatisticsWaitBuckets - 1)) {
+		bound >>= 1;
+		bucket++;
+	}
+	__atomic_fetch_add(&histogram->count, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&histogram->totalNanoseconds, elapsed, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&histogram->buckets[bucket], 1, __ATOMIC_RELAXED);
+}
+
+/**
+ Returns histogram as a dictionary for a -statistics method
+ 
+ The dictionary contains the count of waits, the total time waited in
+ nanoseconds & an array of buckets each with the count of waits shorter than
+ its upper bound in nanoseconds. The last bucket has no upper bound.
+ */
+NSDictionary *CWStatisticsWaitHistogramDictionary(CWStatisticsWaitHistogram *histogram);
+
+#if CW_STATISTICS
+#define CWStatisticsCount(counter) CWStatisticsIncrement(&(counter))
+#define CWStatisticsAdd(counter, value) CWStatisticsAddValue(&(counter), (uint64_t)(value))
+#define CWStatisticsHighWater(highWater, value) CWStatisticsRecordHighWater(&(highWater), (uint64_t)(value))
+#define CWStatisticsWaitBegin() uint64_t cwWaitStart = CWStatisticsNow()
+#define CWStatisticsWaitEnd(histogram) CWStatisticsRecordWait(&(histogram), cwWaitStart)
+#else
+#define CWStatisticsCount(counter)
+#define CWStatisticsAdd(counter, value)
+#define CWStatisticsHighWater(highWater, value)
+#define CWStatisticsWaitBegin()
+#define CWStatisticsWaitEnd(histogram)
+#endif
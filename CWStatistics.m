@@ -0,0 +1,49 @@
+/*
+//  CWStatistics.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWStatistics.h"
+
+NSDictionary *CWStatisticsWaitHistogramDictionary(CWStatisticsWaitHistogram *histogram) {
+	NSMutableArray *buckets = [NSMutableArray arrayWithCapacity:kCWStatisticsWaitBuckets];
+	for (NSUInteger i = 0; i < kCWStatisticsWaitBuckets; i++) {
+		NSNumber *count = @(CWStatisticsLoad(&histogram->buckets[i]));
+		if (i == (kCWStatisticsWaitBuckets - 1)) {
+			[buckets addObject:@{ @"count" : count }];
+		} else {
+			uint64_t upperBound = 1ULL << (i + kCWStatisticsWaitFirstBucketShift);
+			[buckets addObject:@{ @"count" : count, @"upperBoundNanoseconds" : @(upperBound) }];
+		}
+	}
+	return @{ @"count" : @(CWStatisticsLoad(&histogram->count)),
+			  @"totalNanoseconds" : @(CWStatisticsLoad(&histogram->totalNanoseconds)),
+			  @"buckets" : buckets };
+}
@@ -52,6 +52,10 @@
 /**
  Parent Object which is also a CWTreeNode
 
+ Setting the parent recomputes the cached level & jump pointer of the node and
+ of every node below it, so reparenting a node costs O(n) in the size of its
+ subtree. -addChild: & -removeChild: set this for you.
+
  @return a weak reference to the parent of the node
  */
 @property(weak) id parent;
@@ -66,6 +70,12 @@
 /**
  Key to set if a node allows duplicate children
 
+ While duplicates are not allowed the node keeps a hash map from child values to
+ children next to its children array, so checking for a duplicate, looking up a
+ child by value and checking if a node is a child take constant time. The
+ children array should not be mutated directly while duplicates are disallowed,
+ otherwise the map no longer matches it.
+
  @return YES if duplicates are allowed, NO otherwise
  */
 @property(assign) BOOL allowsDuplicates;
@@ -89,6 +99,7 @@
  not then it checks the node values of its children to make sure there isn't 
  already a node with the same value there if there isn't then it proceeds and 
  adds the node to the receivers chilren and sets itself as the nodes parent.
+ When duplicates are not allowed both checks are hash lookups.
  
  @param node a CWTreeNode object
  */
@@ -99,11 +110,30 @@
  
  The receiver checks to make sure the node is in its children and if node is,
  then it removes itself as a parent and removes the node from its chilren.
+ Finding node takes one scan of the children & removing it shifts the children
+ after it down, so removals cost O(n) in the number of children. Removal is not
+ O(1) because children is an ordered NSMutableArray that callers index into:
+ keeping a child to index map beside it would not help, as every removal moves
+ the index of each later child & the map would need the same O(n) update. When
+ duplicates are not allowed a node whose value no child holds is rejected with
+ a hash lookup instead, and adding, duplicate checks & -childWithValue: are
+ O(1).
  
  @param a CWTreeNode object
  */
 -(void)removeChild:(CWTreeNode *)node;
 
+/**
+ Returns the first child of the receiver whose value is equal to value
+ 
+ When the receiver does not allow duplicates this is a hash lookup, otherwise 
+ the receivers children are searched in order.
+ 
+ @param value the value to look for
+ @return the matching child CWTreeNode or nil if no child holds value
+ */
+-(CWTreeNode *)childWithValue:(id)value;
+
 /**
  Returns if the receivers value & node pointers are all equal to node
  
@@ -115,6 +145,39 @@
  */
 -(BOOL)isEqualToNode:(CWTreeNode *)node;
 
+/**
+ Returns a hash of the receivers value and the hashes of all its children
+ 
+ This is a merkle hash of the whole subtree under the receiver. It is cached in
+ every node and only recomputed for nodes whose subtree changed since it was
+ last asked for, since adding or removing a child or changing a value just marks
+ the path up to the root as needing a new hash. Equal subtrees always have equal
+ hashes, so different hashes prove two subtrees differ. Equal hashes do not
+ prove two subtrees are equal, how likely they are to relies on the node values
+ -hash implementations, so the methods using this confirm equal hashes node by
+ node.
+ 
+ The cached hashes are updated without any synchronization. This must not be
+ called from a block passed to -[CWTree concurrentEnumerateTreeWithBlock:] or
+ -[CWTree reduceSubtreesWithBlock:], or otherwise while another thread uses
+ the same tree.
+ 
+ @return a NSUInteger hash of the receivers subtree
+ */
+-(NSUInteger)subtreeHash;
+
+/**
+ Returns if the receivers subtree has the same shape & values as nodes subtree
+ 
+ Unlike -isEqualToNode: this ignores the parents of the two nodes and compares 
+ children by value instead of by identity. Subtrees with different hashes are
+ rejected immediately, otherwise the subtrees are compared node by node.
+ 
+ @param node a valid CWTreeNode object
+ @return YES if both subtrees have the same values in the same shape
+ */
+-(BOOL)isStructurallyEqualToNode:(CWTreeNode *)node;
+
 /**
  Returns a bool value indicating if nodes value is equal to the receivers
  
@@ -126,9 +189,63 @@
 /**
  Returns the depth level of the node in the tree it is in
  
+ The level is cached & updated for the whole subtree whenever a node is given a
+ new parent, so this is a constant time call. Attaching or detaching a subtree
+ therefore costs time proportional to the size of the subtree. A node that
+ outlives its parent becomes the root of its own tree, its subtree's levels are
+ updated when the parent is deallocated.
+ 
  @return a NSUInteger with the depth level of the node in its graph of nodes
  */
 -(NSUInteger)nodeLevel;
+
+/**
+ Returns a BOOL indicating if the receiver is a proper ancestor of node
+ 
+ Each node keeps a single jump pointer to one of its ancestors which lets this
+ reach the receivers level from node in O(log n) steps.
+ 
+ @param node the possible descendant of the receiver
+ @return YES if the receiver is node's parent, grandparent, etc. otherwise NO
+ */
+-(BOOL)isAncestorOf:(CWTreeNode *)node;
+
+/**
+ Returns the deepest node that is an ancestor of or equal to both the receiver
+ and node in O(log n) steps
+ 
+ @param node the node to find the common ancestor with
+ @return the lowest common ancestor or nil if the nodes are not in the same tree
+ */
+-(CWTreeNode *)lowestCommonAncestorWith:(CWTreeNode *)node;
+@end
+
+/**
+ CWTreeDiff describes the differences between two CWTree objects
+ */
+@interface CWTreeDiff : NSObject
+
+/**
+ Roots of the subtrees in the other tree that are not in the receiving tree
+ */
+@property(readonly, strong) NSArray *addedNodes;
+
+/**
+ Roots of the subtrees in the receiving tree that are not in the other tree
+ */
+@property(readonly, strong) NSArray *removedNodes;
+
+/**
+ Maps each node in the receiving tree whose value changed to its counterpart
+ in the other tree
+ */
+@property(readonly, strong) NSMapTable *changedNodes;
+
+/**
+ Returns YES if the diff has no added, removed or changed nodes
+ */
+-(BOOL)isEmpty;
+
 @end
 
 @interface CWTree : NSObject
@@ -163,21 +280,125 @@
  */
 -(void)enumerateTreeWithBlock:(void (^)(id nodeValue, id node, BOOL *stop))block;
 
+/**
+ How many subtrees the concurrent methods look for per work item
+
+ The concurrent enumeration & reduction methods expand the tree level by level
+ until they have this many independent subtrees for each of the work items they
+ dispatch (a few per active processor) and then process those subtrees in
+ parallel. More subtrees per work item even out subtrees of different sizes at
+ the cost of expanding more of the tree serially. Expansion stops after a fixed
+ number of levels, trees that are too small or too narrow by then to give every
+ processor a subtree are processed serially on the calling thread. Defaults to
+ 16.
+ */
+@property(assign) NSUInteger concurrentGrainSize;
+
+/**
+ Enumerates all nodes in the tree concurrently
+
+ The upper levels of the tree are visited serially on the calling thread until
+ enough independent subtrees have been found, after which the subtrees are
+ visited in parallel using dispatch_apply. Each subtree is enumerated level by
+ level, but no ordering is guaranteed between nodes in different subtrees. This
+ method does not return until every node has been visited or the enumeration
+ has been stopped. The tree must not be mutated while it is being enumerated
+ and the block must not ask nodes for their -subtreeHash, which is cached
+ without synchronization.
+
+ Block values passed back to you are as follows
+ @param nodeValue a convenience to accessing [(CWTreeNode *) node nodeValue]
+ @param node a pointer to the node being enumerated over
+ @param stop a BOOL pointer which you can set to YES to stop enumeration. Work
+ items already running on other threads may still visit a few more nodes before
+ they notice enumeration has been stopped.
+ */
+-(void)concurrentEnumerateTreeWithBlock:(void (^)(id nodeValue, id node, BOOL *stop))block;
+
+/**
+ Computes a value for every subtree in the tree, in parallel where possible
+
+ The block is called once for every node after it has been called for all of
+ that nodes children and is passed the results of those calls in the same order
+ as the nodes children. A nil result is passed on to the parent as NSNull.
+ Independent subtrees are reduced concurrently the same way as in
+ -concurrentEnumerateTreeWithBlock: so the block must be safe to call from
+ multiple threads at once. The tree must not be mutated while it is reduced
+ and the block must not ask nodes for their -subtreeHash.
+
+ @param block returns the result for node given the results of its children
+ @return the result the block returned for the root node or nil if there is none
+ */
+-(id)reduceSubtreesWithBlock:(id (^)(id nodeValue, CWTreeNode *node, NSArray *childResults))block;
+
 /**
  Returns a bool indicating if the tree object is equal to the receiver tree
  
+ Trees are equal when their root nodes are structurally equal, see 
+ -[CWTreeNode isStructurallyEqualToNode:]. Trees with different root hashes are
+ rejected without walking either tree.
+ 
  @return a BOOL if the receivers children objects are equal to tree's children
  */
 -(BOOL)isEqualToTree:(CWTree *)tree;
 
+/**
+ Returns the differences between the receiver and tree
+ 
+ The trees are walked together from the root. Subtrees whose hashes differ are
+ descended into straight away. Subtrees whose hashes are equal are confirmed
+ equal node by node & then skipped, since equal hashes alone could hide a real
+ difference. That check is far cheaper than diffing the subtree, but the time
+ taken still grows with the size of the trees. Children are matched by
+ value first, children left over on both sides are then paired by position and
+ reported as changed and anything left after that is reported as added or 
+ removed.
+ 
+ @param tree the tree to compare the receiver to
+ @return a CWTreeDiff describing how to get from the receiver to tree
+ */
+-(CWTreeDiff *)diffWithTree:(CWTree *)tree;
+
+/**
+ Key to set if the receiver keeps an index from node values to nodes
+
+ When set to YES the receiver walks the tree once & builds a hash index from
+ each node value to the nodes holding it. From then on -addChild:, -removeChild:
+ and changes to a nodes value keep the index up to date, and -containsObject:
+ and -nodesWithValue: become hash lookups instead of walking the whole tree.
+ Adding or removing a subtree costs time proportional to the size of the
+ subtree, since each of its nodes has to be added to or removed from the index.
+
+ The index costs one NSMapTable entry (a key & value pointer plus hash table
+ slack, roughly 32 bytes) per distinct value, a NSHashTable (roughly 64 bytes
+ plus 16 bytes per node) for each value held by more than one node, and a weak
+ back pointer to the tree in every node. Node values must implement -hash and
+ -isEqual: consistently. Defaults to NO.
+ */
+@property(nonatomic, assign) BOOL indexesNodeValues;
+
 /**
  Returns a BOOL indicating if the object argument is contained in the receiver
  
+ If the receiver indexes its node values this is a hash lookup, otherwise the
+ tree is enumerated until a node with a matching value is found.
+ 
  @param object the object you wish to see if its contained in the receiver
  @return YES if object is contained in the block or NO otherwise
  */
 -(BOOL)containsObject:(id)object;
 
+/**
+ Returns all the nodes in the receiver whose value is equal to value
+ 
+ If the receiver indexes its node values this is a hash lookup, otherwise the
+ whole tree is enumerated. The order of the returned nodes is not defined.
+ 
+ @param value the value to look for
+ @return a NSArray of CWTreeNodes, which is empty if no node holds value
+ */
+-(NSArray *)nodesWithValue:(id)value;
+
 /**
  Returns a BOOL indicating if the object argument is contained in the receiver
  
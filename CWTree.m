@@ -34,12 +34,106 @@
 #import "CWTree.h"
 #import "CWQueue.h" // enumeration support
 
-@interface CWTreeNode()
+#define kCWTreeDefaultConcurrentGrainSize 16
+//how many concurrent work items are dispatched per active processor
+#define kCWTreeSubtreesPerProcessor 8
+//how many levels are expanded looking for subtrees before giving up on width
+#define kCWTreeMaxConcurrentExpansionLevels 32
+
+typedef void (^CWTreeEnumerationBlock)(id nodeValue, id node, BOOL *stop);
+typedef id (^CWTreeReduceBlock)(id nodeValue, CWTreeNode *node, NSArray *childResults);
+
+@interface CWTreeNode() {
+	//cached depth, kept current whenever a node is (re)parented
+	NSUInteger _level;
+	//skew binary jump pointer to an ancestor, nil for a root node
+	__weak CWTreeNode *_jump;
+	//merkle hash of the value & children, recomputed lazily after mutations
+	NSUInteger _subtreeHash;
+	BOOL _subtreeHashValid;
+}
 @property(readwrite, strong) NSMutableArray *children;
+//maps child values to children, only kept while duplicates are not allowed
+@property(strong) NSMapTable *childrenByValue;
+//YES if children sharing a value were already present when the map was built
+@property(assign) BOOL childrenShareValues;
+//set only while the node belongs to a tree that indexes its node values
+@property(weak) CWTree *tree;
+@end
+
+@interface CWTree ()
+//maps a node value to the CWTreeNode holding it or a NSHashTable of such nodes
+@property(strong) NSMapTable *valueIndex;
+-(void)_indexSubtree:(CWTreeNode *)node;
+-(void)_unindexSubtree:(CWTreeNode *)node;
+-(void)_indexValue:(id)value forNode:(CWTreeNode *)node;
+-(void)_unindexValue:(id)value forNode:(CWTreeNode *)node;
+@end
+
+@interface CWTreeDiff ()
+@property(readwrite, strong) NSMutableArray *addedNodes;
+@property(readwrite, strong) NSMutableArray *removedNodes;
+@property(readwrite, strong) NSMapTable *changedNodes;
+@end
+
+@implementation CWTreeDiff
+
+-(instancetype)init {
+	self = [super init];
+	if (self == nil) return nil;
+	
+	_addedNodes = [NSMutableArray array];
+	_removedNodes = [NSMutableArray array];
+	_changedNodes = [NSMapTable mapTableWithKeyOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality)
+										  valueOptions:NSPointerFunctionsStrongMemory];
+	
+	return self;
+}
+
+-(BOOL)isEmpty {
+	return (self.addedNodes.count == 0) && (self.removedNodes.count == 0) && (self.changedNodes.count == 0);
+}
+
+-(NSString *)description {
+	return [NSString stringWithFormat:@"%@: Added: %@\nRemoved: %@\nChanged: %@",
+			NSStringFromClass([self class]),
+			self.addedNodes,
+			self.removedNodes,
+			self.changedNodes];
+}
+
 @end
 
+/**
+ Mixes value into a running hash (the boost hash_combine mix)
+ */
+static inline NSUInteger CWTreeHashCombine(NSUInteger seed, NSUInteger value) {
+	return seed ^ (value + (NSUInteger)0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+static inline BOOL CWTreeValuesEqual(id value1, id value2) {
+	return (value1 == value2) || [value1 isEqual:value2];
+}
+
+/**
+ Calls visitor for node and all of its descendants, parents before children
+ */
+static void CWTreeVisitSubtree(CWTreeNode *node, void (^visitor)(CWTreeNode *node)) {
+	NSMutableArray *pending = [NSMutableArray arrayWithObject:node];
+	while (pending.count > 0) {
+		CWTreeNode *current = [pending lastObject];
+		[pending removeLastObject];
+		visitor(current);
+		[pending addObjectsFromArray:current.children];
+	}
+}
+
 @implementation CWTreeNode
 
+@synthesize value = _value;
+@synthesize allowsDuplicates = _allowsDuplicates;
+@synthesize parent = _parent;
+
 /**
  Initializes and creates a new CWTreenode Object
  
@@ -53,6 +147,9 @@
 	_children = [NSMutableArray array];
 	_parent = nil;
 	_allowsDuplicates = YES;
+	_level = 1;
+	_jump = nil;
+	_subtreeHashValid = NO;
 	
     return self;
 }
@@ -64,10 +161,30 @@
 	_value = aValue;
 	_children = [NSMutableArray array];
 	_parent = nil;
+	_level = 1;
+	_jump = nil;
+	_subtreeHashValid = NO;
 	
     return self;
 }
 
+/**
+ Children that outlive the receiver become roots. Children nobody else holds
+ are released first, so each surviving subtree has its ancestry recomputed
+ once instead of once for every ancestor deallocated above it.
+ */
+-(void)dealloc {
+	if (_children.count == 0) return;
+	NSPointerArray *children = [NSPointerArray weakObjectsPointerArray];
+	for (CWTreeNode *child in _children) [children addPointer:(__bridge void *)child];
+	_children = nil;
+	_childrenByValue = nil;
+	for (NSUInteger i = 0; i < children.count; i++) {
+		CWTreeNode *child = (__bridge CWTreeNode *)[children pointerAtIndex:i];
+		if (child) child.parent = nil;
+	}
+}
+
 /**
  Returns a NSString with the description of the receiving CWTreeNode Object
  
@@ -84,37 +201,250 @@
 }
 
 
+-(id)value {
+	return _value;
+}
+
+-(void)setValue:(id)value {
+	id oldValue = _value;
+	CWTree *tree = self.tree;
+	if (tree) [tree _unindexValue:oldValue forNode:self];
+	_value = value;
+	if (tree) [tree _indexValue:value forNode:self];
+	[self _invalidateSubtreeHash];
+	
+	CWTreeNode *parent = self.parent;
+	if (parent.childrenByValue) [parent _child:self didChangeValueFrom:oldValue];
+}
+
+-(id)parent {
+	return _parent;
+}
+
+/**
+ Sets the receivers parent & recomputes the ancestry of its whole subtree
+ 
+ Every level & jump pointer below the receiver depends on its level, so this
+ is O(n) in the size of the receivers subtree.
+ */
+-(void)setParent:(id)parent {
+	_parent = parent;
+	[self _updateAncestry];
+	for (CWTreeNode *child in self.children) {
+		CWTreeVisitSubtree(child, ^(CWTreeNode *node) {
+			[node _updateAncestry];
+		});
+	}
+}
+
+-(BOOL)allowsDuplicates {
+	return _allowsDuplicates;
+}
+
+-(void)setAllowsDuplicates:(BOOL)allowsDuplicates {
+	_allowsDuplicates = allowsDuplicates;
+	if (allowsDuplicates) {
+		self.childrenByValue = nil;
+	} else if (self.childrenByValue == nil && self.children.count > 0) {
+		//childless nodes get their map from -addChild: when they need one
+		[self _rebuildChildrenByValue];
+	}
+}
+
+#pragma mark Child Value Map -
+
+/**
+ Rebuilds the map from child values to children, the first child wins
+ */
+-(void)_rebuildChildrenByValue {
+	NSMapTable *map = [NSMapTable strongToStrongObjectsMapTable];
+	BOOL shareValues = NO;
+	for (CWTreeNode *child in self.children) {
+		id childValue = child.value;
+		if (childValue == nil) continue;
+		if ([map objectForKey:childValue] == nil) {
+			[map setObject:child forKey:childValue];
+		} else {
+			shareValues = YES;
+		}
+	}
+	self.childrenByValue = map;
+	self.childrenShareValues = shareValues;
+}
+
+/**
+ Removes child from the child value map under value
+ 
+ If children sharing a value were added before duplicates were disallowed then
+ the next child with the same value takes its place in the map.
+ */
+-(void)_unmapChild:(CWTreeNode *)child withValue:(id)value {
+	NSMapTable *map = self.childrenByValue;
+	if (value == nil || [map objectForKey:value] != child) return;
+	[map removeObjectForKey:value];
+	if (!self.childrenShareValues) return;
+	for (CWTreeNode *other in self.children) {
+		if (other != child && [other.value isEqual:value]) {
+			[map setObject:other forKey:value];
+			break;
+		}
+	}
+}
+
+-(void)_child:(CWTreeNode *)child didChangeValueFrom:(id)oldValue {
+	[self _unmapChild:child withValue:oldValue];
+	id newValue = child.value;
+	if (newValue == nil) return;
+	if ([self.childrenByValue objectForKey:newValue] == nil) {
+		[self.childrenByValue setObject:child forKey:newValue];
+	} else {
+		self.childrenShareValues = YES;
+	}
+}
+
+-(CWTreeNode *)childWithValue:(id)value {
+	if (value == nil) return nil;
+	if (!self.allowsDuplicates) {
+		if (self.childrenByValue == nil) [self _rebuildChildrenByValue];
+		return [self.childrenByValue objectForKey:value];
+	}
+	for (CWTreeNode *child in self.children) {
+		if ([child.value isEqual:value]) return child;
+	}
+	return nil;
+}
+
+#pragma mark Adding & Removing Children -
+
+/**
+ Moves the index entries for a newly added child to the receivers tree
+ */
+-(void)_didAddChild:(CWTreeNode *)node {
+	[self _invalidateSubtreeHash];
+	CWTree *oldTree = node.tree;
+	CWTree *newTree = self.tree;
+	if (oldTree == newTree) return;
+	if (oldTree) [oldTree _unindexSubtree:node];
+	if (newTree) [newTree _indexSubtree:node];
+}
+
 -(void)addChild:(CWTreeNode *)node {
 	if(node == nil) return;
 	if (self.allowsDuplicates) {
 		node.parent = self;
 		[self.children addObject:node];
+		[self _didAddChild:node];
 	} else {
-		if (![self.children containsObject:node]) {
-			__block BOOL anyNodeContainsValue = NO;
-			[self.children enumerateObjectsUsingBlock:^(CWTreeNode *obj, NSUInteger idx, BOOL *stop) {
-				if ([obj.value isEqual:node.value]) {
-					anyNodeContainsValue = YES;
-					*stop = YES;
-				}
-			}];
-			if (!anyNodeContainsValue) {
-				node.parent = self;
-				node.allowsDuplicates = NO;
-				[self.children addObject:node];
-			}
+		if (self.childrenByValue == nil) [self _rebuildChildrenByValue];
+		id nodeValue = node.value;
+		if (nodeValue) {
+			//a node already in our children is found by its value as well
+			if ([self.childrenByValue objectForKey:nodeValue] != nil) return;
+		} else {
+			//nil values never match another node so only look for node itself
+			if ([self.children indexOfObjectIdenticalTo:node] != NSNotFound) return;
 		}
+		node.parent = self;
+		node.allowsDuplicates = NO;
+		[self.children addObject:node];
+		if (nodeValue) [self.childrenByValue setObject:node forKey:nodeValue];
+		[self _didAddChild:node];
 	}
 }
 
-
 -(void)removeChild:(CWTreeNode *)node {
-	if(![self.children containsObject:node]) return;
+	if(node == nil) return;
+	id nodeValue = node.value;
+	NSMapTable *map = self.childrenByValue;
+	//with a child map a value no child holds tells us in O(1) node isn't a child
+	if (map && nodeValue && [map objectForKey:nodeValue] == nil) return;
+	NSUInteger index = [self.children indexOfObjectIdenticalTo:node];
+	if (index == NSNotFound) return;
 	node.parent = nil;
-	[self.children removeObject:node];
+	[self.children removeObjectAtIndex:index];
+	if (map) [self _unmapChild:node withValue:nodeValue];
+	[self _invalidateSubtreeHash];
+	CWTree *tree = node.tree;
+	if (tree) [tree _unindexSubtree:node];
+}
+
+#pragma mark Equality -
+
+/**
+ Marks the receivers hash and those of its ancestors as needing recomputation
+ 
+ A node with an invalid hash never has an ancestor with a valid one, so this
+ stops at the first ancestor that is already invalid.
+ */
+-(void)_invalidateSubtreeHash {
+	CWTreeNode *node = self;
+	while (node && node->_subtreeHashValid) {
+		node->_subtreeHashValid = NO;
+		node = node.parent;
+	}
+}
+
+-(NSUInteger)subtreeHash {
+	if (_subtreeHashValid) return _subtreeHash;
+	
+	//the cache isn't synchronized, so only one thread may use a tree at a time
+	
+	//collect the invalid nodes parents first, skipping still valid subtrees
+	NSMutableArray *invalidNodes = [NSMutableArray array];
+	NSMutableArray *pending = [NSMutableArray arrayWithObject:self];
+	while (pending.count > 0) {
+		CWTreeNode *node = [pending lastObject];
+		[pending removeLastObject];
+		[invalidNodes addObject:node];
+		for (CWTreeNode *child in node.children) {
+			if (!child->_subtreeHashValid) [pending addObject:child];
+		}
+	}
+	//then hash them children first
+	for (CWTreeNode *node in [invalidNodes reverseObjectEnumerator]) {
+		NSUInteger hash = [node.value hash];
+		for (CWTreeNode *child in node.children) {
+			hash = CWTreeHashCombine(hash, child->_subtreeHash);
+		}
+		node->_subtreeHash = CWTreeHashCombine(hash, node.children.count);
+		node->_subtreeHashValid = YES;
+	}
+	return _subtreeHash;
+}
+
+-(BOOL)isStructurallyEqualToNode:(CWTreeNode *)node {
+	if (node == nil) return NO;
+	if (node == self) return YES;
+	if (self.subtreeHash != node.subtreeHash) return NO;
+	
+	//equal hashes are very likely equal trees, but confirm it node by node
+	NSMutableArray *pending = [NSMutableArray arrayWithObjects:self, node, nil];
+	while (pending.count > 0) {
+		CWTreeNode *b = [pending lastObject];
+		[pending removeLastObject];
+		CWTreeNode *a = [pending lastObject];
+		[pending removeLastObject];
+		if (a == b) continue;
+		if (a->_subtreeHash != b->_subtreeHash ||
+			a.children.count != b.children.count ||
+			!CWTreeValuesEqual(a.value, b.value)) {
+			return NO;
+		}
+		NSUInteger childCount = a.children.count;
+		for (NSUInteger i = 0; i < childCount; i++) {
+			[pending addObject:a.children[i]];
+			[pending addObject:b.children[i]];
+		}
+	}
+	return YES;
 }
 
 -(BOOL)isEqualToNode:(CWTreeNode *)node {
+	//equal nodes have identical children, so cached hashes that differ rule it out
+	if (_subtreeHashValid && node && node->_subtreeHashValid &&
+		_subtreeHash != node->_subtreeHash) {
+		return NO;
+	}
 	__typeof(self.parent) __strong selfParent = self.parent;
 	__typeof(node.parent) __strong nodeParent = node.parent;
 	if ([node.value isEqual:self.value]   &&
@@ -129,31 +459,264 @@
     return [node.value isEqual:self.value];
 }
 
+#pragma mark Ancestry -
+
+/**
+ Recomputes the receivers level & jump pointer from its parent
+ 
+ The jump pointers form a skew binary ladder (Myers 1983): a node jumps either
+ to its parent or, when its parents jump and its parents jumps jump span the
+ same number of levels, straight past both of them. This needs one pointer per
+ node, depends only on the path to the root and lets any ancestor be reached in
+ O(log n) hops. The parent must already be up to date.
+ */
+-(void)_updateAncestry {
+	CWTreeNode *parent = _parent;
+	if (parent == nil) {
+		_level = 1;
+		_jump = nil;
+		return;
+	}
+	_level = parent->_level + 1;
+	//a root node acts as its own jump target
+	CWTreeNode *parentJump = parent->_jump ?: parent;
+	CWTreeNode *parentJumpJump = parentJump->_jump ?: parentJump;
+	if ((parent->_level - parentJump->_level) == (parentJump->_level - parentJumpJump->_level)) {
+		_jump = parentJumpJump;
+	} else {
+		_jump = parent;
+	}
+}
+
+/**
+ Returns the ancestor of node at level, or nil if the path to it is broken
+ */
+static CWTreeNode *CWTreeNodeAncestorAtLevel(CWTreeNode *node, NSUInteger level) {
+	while (node && node->_level > level) {
+		CWTreeNode *jump = node->_jump;
+		node = (jump && jump->_level >= level) ? jump : node.parent;
+	}
+	return node;
+}
+
 -(NSUInteger)nodeLevel {
-    NSUInteger level = 1;
-    CWTreeNode *currentNode = self.parent;
-    while (currentNode) {
-        level++;
-        currentNode = currentNode.parent;
-    }
-    return level;
+	return _level;
+}
+
+-(BOOL)isAncestorOf:(CWTreeNode *)node {
+	if (node == nil || node->_level <= _level) return NO;
+	return (CWTreeNodeAncestorAtLevel(node, _level) == self);
+}
+
+-(CWTreeNode *)lowestCommonAncestorWith:(CWTreeNode *)node {
+	if (node == nil) return nil;
+	CWTreeNode *a = CWTreeNodeAncestorAtLevel(self, MIN(_level, node->_level));
+	CWTreeNode *b = CWTreeNodeAncestorAtLevel(node, MIN(_level, node->_level));
+	//nodes on the same level always have jump pointers to the same level
+	while (a && b && a != b) {
+		CWTreeNode *aJump = a->_jump;
+		CWTreeNode *bJump = b->_jump;
+		if (aJump && bJump && aJump != bJump) {
+			a = aJump;
+			b = bJump;
+		} else {
+			a = a.parent;
+			b = b.parent;
+		}
+	}
+	return (a == b) ? a : nil;
+}
+
+@end
+
+/**
+ A pending node in a serial subtree reduction along with the results its 
+ children have produced so far
+ */
+@interface CWTreeReduceFrame : NSObject
+@property(strong) CWTreeNode *node;
+@property(assign) NSUInteger nextChild;
+@property(strong) NSMutableArray *childResults;
+@end
+
+@implementation CWTreeReduceFrame
+
++(instancetype)frameWithNode:(CWTreeNode *)node {
+	CWTreeReduceFrame *frame = [self new];
+	frame.node = node;
+	frame.nextChild = 0;
+	frame.childResults = [NSMutableArray arrayWithCapacity:node.children.count];
+	return frame;
 }
 
 @end
 
+/**
+ Enumerates a single subtree level by level on the calling thread
+ 
+ This uses a plain NSMutableArray as the queue instead of a CWQueue, since the
+ subtree is private to the calling work item and needs no synchronization.
+ */
+static void CWTreeEnumerateSubtree(CWTreeNode *subtreeRoot,
+								   CWTreeEnumerationBlock block,
+								   BOOL *shouldStop) {
+	NSMutableArray *pending = [NSMutableArray arrayWithObject:subtreeRoot];
+	NSUInteger head = 0;
+	while (head < pending.count) {
+		if (__atomic_load_n(shouldStop, __ATOMIC_RELAXED)) return;
+		CWTreeNode *node = pending[head++];
+		BOOL stop = NO;
+		block(node.value, node, &stop);
+		if (stop) {
+			__atomic_store_n(shouldStop, YES, __ATOMIC_RELAXED);
+			return;
+		}
+		[pending addObjectsFromArray:node.children];
+		//drop visited nodes once they make up most of the queue
+		if (head >= 1024 && head >= (pending.count / 2)) {
+			[pending removeObjectsInRange:NSMakeRange(0, head)];
+			head = 0;
+		}
+	}
+}
+
+/**
+ Reduces a single subtree on the calling thread
+ 
+ This is done iteratively with an explicit stack of frames so that very deep
+ subtrees do not overflow the threads stack.
+ */
+static id CWTreeReduceSubtree(CWTreeNode *subtreeRoot, CWTreeReduceBlock block) {
+	NSMutableArray *frames = [NSMutableArray arrayWithObject:[CWTreeReduceFrame frameWithNode:subtreeRoot]];
+	id result = nil;
+	while (frames.count > 0) {
+		CWTreeReduceFrame *frame = [frames lastObject];
+		if (frame.nextChild < frame.node.children.count) {
+			CWTreeNode *child = frame.node.children[frame.nextChild];
+			frame.nextChild++;
+			[frames addObject:[CWTreeReduceFrame frameWithNode:child]];
+			continue;
+		}
+		result = block(frame.node.value, frame.node, frame.childResults);
+		[frames removeLastObject];
+		CWTreeReduceFrame *parentFrame = [frames lastObject];
+		[parentFrame.childResults addObject:(result ?: [NSNull null])];
+	}
+	return result;
+}
+
 @implementation CWTree
 
+@synthesize rootNode = _rootNode;
+
+-(id)init {
+	self = [super init];
+	if (self == nil) return nil;
+	
+	_rootNode = nil;
+	_concurrentGrainSize = kCWTreeDefaultConcurrentGrainSize;
+	
+	return self;
+}
+
 -(id)initWithRootNodeValue:(id)value {
     self = [super init];
     if (self == nil) return nil;
     
     _rootNode = [[CWTreeNode alloc] initWithValue:value];
+	_concurrentGrainSize = kCWTreeDefaultConcurrentGrainSize;
     
     return self;
 }
 
+-(CWTreeNode *)rootNode {
+	return _rootNode;
+}
+
+-(void)setRootNode:(CWTreeNode *)rootNode {
+	if (self.indexesNodeValues) {
+		if (_rootNode) [self _unindexSubtree:_rootNode];
+		if (rootNode) [self _indexSubtree:rootNode];
+	}
+	_rootNode = rootNode;
+}
+
 -(BOOL)isEqualToTree:(CWTree *)tree {
-	return [self.rootNode isEqualToNode:tree.rootNode];
+	return [self.rootNode isStructurallyEqualToNode:tree.rootNode];
+}
+
+#pragma mark Diffing -
+
+-(CWTreeDiff *)diffWithTree:(CWTree *)tree {
+	CWTreeDiff *diff = [CWTreeDiff new];
+	CWTreeNode *root = self.rootNode;
+	CWTreeNode *otherRoot = tree.rootNode;
+	if (root == nil || otherRoot == nil) {
+		if (root) [diff.removedNodes addObject:root];
+		if (otherRoot) [diff.addedNodes addObject:otherRoot];
+		return diff;
+	}
+	if (!CWTreeValuesEqual(root.value, otherRoot.value)) {
+		[diff.changedNodes setObject:otherRoot forKey:root];
+	}
+	
+	NSMutableArray *pending = [NSMutableArray arrayWithObjects:root, otherRoot, nil];
+	while (pending.count > 0) {
+		CWTreeNode *b = [pending lastObject];
+		[pending removeLastObject];
+		CWTreeNode *a = [pending lastObject];
+		[pending removeLastObject];
+		//equal hashes only hint at equal subtrees, so confirm before skipping
+		if (CWTreeValuesEqual(a.value, b.value) && [a isStructurallyEqualToNode:b]) continue;
+		
+		//match children by value first, so insertions & reorders line up
+		NSMapTable *otherChildrenByValue = [NSMapTable strongToStrongObjectsMapTable];
+		for (CWTreeNode *child in b.children) {
+			if (child.value == nil) continue;
+			NSMutableArray *candidates = [otherChildrenByValue objectForKey:child.value];
+			if (candidates == nil) {
+				candidates = [NSMutableArray array];
+				[otherChildrenByValue setObject:candidates forKey:child.value];
+			}
+			[candidates addObject:child];
+		}
+		NSHashTable *matched = [NSHashTable hashTableWithOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality)];
+		NSMutableArray *unmatched = [NSMutableArray array];
+		for (CWTreeNode *child in a.children) {
+			NSMutableArray *candidates = (child.value != nil) ? [otherChildrenByValue objectForKey:child.value] : nil;
+			if (candidates.count == 0) {
+				[unmatched addObject:child];
+				continue;
+			}
+			CWTreeNode *counterpart = candidates[0];
+			[candidates removeObjectAtIndex:0];
+			[matched addObject:counterpart];
+			[pending addObject:child];
+			[pending addObject:counterpart];
+		}
+		NSMutableArray *otherUnmatched = [NSMutableArray array];
+		for (CWTreeNode *child in b.children) {
+			if (![matched containsObject:child]) [otherUnmatched addObject:child];
+		}
+		
+		//whatever is left over is paired up by position, nil values are never
+		//matched above so a pair may still hold equal values
+		NSUInteger pairs = MIN(unmatched.count, otherUnmatched.count);
+		for (NSUInteger i = 0; i < pairs; i++) {
+			if (!CWTreeValuesEqual([unmatched[i] value], [otherUnmatched[i] value])) {
+				[diff.changedNodes setObject:otherUnmatched[i] forKey:unmatched[i]];
+			}
+			[pending addObject:unmatched[i]];
+			[pending addObject:otherUnmatched[i]];
+		}
+		for (NSUInteger i = pairs; i < unmatched.count; i++) {
+			[diff.removedNodes addObject:unmatched[i]];
+		}
+		for (NSUInteger i = pairs; i < otherUnmatched.count; i++) {
+			[diff.addedNodes addObject:otherUnmatched[i]];
+		}
+	}
+	return diff;
 }
 
 -(void)enumerateTreeWithBlock:(void (^)(id nodeValue, id node, BOOL *stop))block {
@@ -175,7 +738,208 @@
 	}
 }
 
+#pragma mark Concurrent Enumeration -
+
+/**
+ Expands the tree level by level until there are enough independent subtrees
+ 
+ Expansion looks for concurrentGrainSize subtrees for every work item that will
+ be dispatched, but gives up after kCWTreeMaxConcurrentExpansionLevels levels so
+ trees whose width levels off are not expanded all the way down serially.
+ 
+ @param upperLevels receives the arrays of nodes on each level above the 
+ returned subtrees, starting with the level containing only the root node
+ @return the roots of the subtrees to be processed concurrently or nil if the
+ tree is too small or too narrow to be worth processing concurrently, in which 
+ case upperLevels is left in an unspecified state
+ */
+-(NSArray *)_concurrentSubtreesWithUpperLevels:(NSMutableArray *)upperLevels {
+	NSUInteger processors = [[NSProcessInfo processInfo] activeProcessorCount];
+	NSUInteger grainSize = MAX(self.concurrentGrainSize, (NSUInteger)1);
+	NSUInteger target = processors * kCWTreeSubtreesPerProcessor;
+	target = (target > (NSUIntegerMax / grainSize)) ? NSUIntegerMax : target * grainSize;
+	NSArray *subtrees = @[ self.rootNode ];
+	NSUInteger levels = 0;
+	while (subtrees.count < target && levels < kCWTreeMaxConcurrentExpansionLevels) {
+		NSMutableArray *nextLevel = [NSMutableArray array];
+		for (CWTreeNode *node in subtrees) {
+			[nextLevel addObjectsFromArray:node.children];
+		}
+		//the whole tree fit in the expansion so it is small enough to do serially
+		if (nextLevel.count == 0) return nil;
+		[upperLevels addObject:subtrees];
+		subtrees = nextLevel;
+		levels++;
+	}
+	//too narrow to give every processor a subtree
+	if (subtrees.count < MAX(processors, (NSUInteger)2)) return nil;
+	return subtrees;
+}
+
+/**
+ Returns how many subtrees each concurrent work item should process
+ */
+-(NSUInteger)_strideForSubtreeCount:(NSUInteger)count {
+	NSUInteger workItems = [[NSProcessInfo processInfo] activeProcessorCount] * kCWTreeSubtreesPerProcessor;
+	NSUInteger stride = (count + workItems - 1) / workItems;
+	return MAX(stride, (NSUInteger)1);
+}
+
+-(void)concurrentEnumerateTreeWithBlock:(void (^)(id nodeValue, id node, BOOL *stop))block {
+	if(self.rootNode == nil) return;
+	
+	NSMutableArray *upperLevels = [NSMutableArray array];
+	NSArray *subtrees = [self _concurrentSubtreesWithUpperLevels:upperLevels];
+	if (subtrees == nil) {
+		[self enumerateTreeWithBlock:block];
+		return;
+	}
+	
+	for (NSArray *level in upperLevels) {
+		for (CWTreeNode *node in level) {
+			BOOL stop = NO;
+			block(node.value, node, &stop);
+			if (stop) return;
+		}
+	}
+	
+	//only ever written with YES, so relaxed loads & stores are all this needs
+	__block BOOL shouldStop = NO;
+	NSUInteger stride = [self _strideForSubtreeCount:subtrees.count];
+	NSUInteger workItems = (subtrees.count + stride - 1) / stride;
+	dispatch_apply(workItems, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t item) {
+		NSUInteger end = MIN((item + 1) * stride, subtrees.count);
+		for (NSUInteger i = item * stride; i < end; i++) {
+			if (__atomic_load_n(&shouldStop, __ATOMIC_RELAXED)) return;
+			CWTreeEnumerateSubtree(subtrees[i], block, &shouldStop);
+		}
+	});
+}
+
+-(id)reduceSubtreesWithBlock:(id (^)(id nodeValue, CWTreeNode *node, NSArray *childResults))block {
+	if(self.rootNode == nil) return nil;
+	
+	NSMutableArray *upperLevels = [NSMutableArray array];
+	NSArray *subtrees = [self _concurrentSubtreesWithUpperLevels:upperLevels];
+	if (subtrees == nil) return CWTreeReduceSubtree(self.rootNode, block);
+	NSUInteger subtreeCount = subtrees.count;
+	
+	__strong id *results = (__strong id *)calloc(subtreeCount, sizeof(id));
+	NSUInteger stride = [self _strideForSubtreeCount:subtreeCount];
+	NSUInteger workItems = (subtreeCount + stride - 1) / stride;
+	dispatch_apply(workItems, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t item) {
+		NSUInteger end = MIN((item + 1) * stride, subtreeCount);
+		for (NSUInteger i = item * stride; i < end; i++) {
+			results[i] = CWTreeReduceSubtree(subtrees[i], block);
+		}
+	});
+	
+	//the levels above the subtrees are small so combine them serially
+	NSMapTable *nodeResults = [NSMapTable mapTableWithKeyOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality)
+													valueOptions:NSPointerFunctionsStrongMemory];
+	for (NSUInteger i = 0; i < subtreeCount; i++) {
+		[nodeResults setObject:(results[i] ?: [NSNull null]) forKey:subtrees[i]];
+		results[i] = nil;
+	}
+	free(results);
+	
+	for (NSArray *level in [upperLevels reverseObjectEnumerator]) {
+		for (CWTreeNode *node in level) {
+			NSMutableArray *childResults = [NSMutableArray arrayWithCapacity:node.children.count];
+			for (CWTreeNode *child in node.children) {
+				[childResults addObject:[nodeResults objectForKey:child]];
+			}
+			id result = block(node.value, node, childResults);
+			[nodeResults setObject:(result ?: [NSNull null]) forKey:node];
+		}
+	}
+	
+	id rootResult = [nodeResults objectForKey:self.rootNode];
+	return (rootResult == [NSNull null]) ? nil : rootResult;
+}
+
+#pragma mark Value Index -
+
+-(void)setIndexesNodeValues:(BOOL)indexesNodeValues {
+	if (_indexesNodeValues == indexesNodeValues) return;
+	_indexesNodeValues = indexesNodeValues;
+	if (indexesNodeValues) {
+		self.valueIndex = [NSMapTable strongToStrongObjectsMapTable];
+		if (self.rootNode) [self _indexSubtree:self.rootNode];
+	} else {
+		if (self.rootNode) [self _unindexSubtree:self.rootNode];
+		self.valueIndex = nil;
+	}
+}
+
+-(void)_indexSubtree:(CWTreeNode *)node {
+	CWTreeVisitSubtree(node, ^(CWTreeNode *current) {
+		CWTree *oldTree = current.tree;
+		if (oldTree && oldTree != self) [oldTree _unindexValue:current.value forNode:current];
+		current.tree = self;
+		[self _indexValue:current.value forNode:current];
+	});
+}
+
+-(void)_unindexSubtree:(CWTreeNode *)node {
+	CWTreeVisitSubtree(node, ^(CWTreeNode *current) {
+		if (current.tree != self) return;
+		[self _unindexValue:current.value forNode:current];
+		current.tree = nil;
+	});
+}
+
+-(void)_indexValue:(id)value forNode:(CWTreeNode *)node {
+	if (value == nil) return;
+	id entry = [self.valueIndex objectForKey:value];
+	if (entry == nil) {
+		[self.valueIndex setObject:node forKey:value];
+	} else if ([entry isKindOfClass:[NSHashTable class]]) {
+		[(NSHashTable *)entry addObject:node];
+	} else if (entry != node) {
+		NSHashTable *nodes = [NSHashTable hashTableWithOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality)];
+		[nodes addObject:entry];
+		[nodes addObject:node];
+		[self.valueIndex setObject:nodes forKey:value];
+	}
+}
+
+-(void)_unindexValue:(id)value forNode:(CWTreeNode *)node {
+	if (value == nil) return;
+	id entry = [self.valueIndex objectForKey:value];
+	if (entry == node) {
+		[self.valueIndex removeObjectForKey:value];
+	} else if ([entry isKindOfClass:[NSHashTable class]]) {
+		NSHashTable *nodes = (NSHashTable *)entry;
+		[nodes removeObject:node];
+		if (nodes.count == 1) {
+			[self.valueIndex setObject:[nodes anyObject] forKey:value];
+		}
+	}
+}
+
+-(NSArray *)nodesWithValue:(id)value {
+	if (value == nil) return @[];
+	if (self.indexesNodeValues) {
+		id entry = [self.valueIndex objectForKey:value];
+		if (entry == nil) return @[];
+		if ([entry isKindOfClass:[NSHashTable class]]) return [(NSHashTable *)entry allObjects];
+		return @[ entry ];
+	}
+	
+	NSMutableArray *nodes = [NSMutableArray array];
+	[self enumerateTreeWithBlock:^(id nodeValue, id node, BOOL *stop) {
+		if ([value isEqual:nodeValue]) [nodes addObject:node];
+	}];
+	return nodes;
+}
+
+#pragma mark Query Methods -
+
 -(BOOL)containsObject:(id)object {
+	if (self.indexesNodeValues) {
+		return (object != nil) && ([self.valueIndex objectForKey:object] != nil);
+	}
 	__block BOOL contains = NO;
 	[self enumerateTreeWithBlock:^(id nodeValue, id node, BOOL *stop) {
 		if ([object isEqual:nodeValue]) {
@@ -33,6 +33,33 @@
 
 #import "CWTree.h"
 
+/**
+ A value whose hash is the same for every instance, so any two trees of the 
+ same shape built from them have the same subtree hashes
+ */
+@interface CWTreeCollidingValue : NSObject
+@property(copy) NSString *name;
+@end
+
+@implementation CWTreeCollidingValue
+
++(instancetype)valueWithName:(NSString *)name {
+	CWTreeCollidingValue *value = [self new];
+	value.name = name;
+	return value;
+}
+
+-(NSUInteger)hash {
+	return 42;
+}
+
+-(BOOL)isEqual:(id)object {
+	if (![object isKindOfClass:[CWTreeCollidingValue class]]) return NO;
+	return [self.name isEqualToString:[(CWTreeCollidingValue *)object name]];
+}
+
+@end
+
 SpecBegin(CWTree)
 
 describe(@"CWTree Root Node", ^{
@@ -63,6 +90,98 @@ describe(@"-isEqualToTree", ^{
 		CWTree *tree3 = nil;
 		expect([tree1 isEqualToTree:tree3]).to.beFalsy();
 	});
+	
+	it(@"should compare separately built trees by shape & value", ^{
+		CWTree *tree1 = [[CWTree alloc] initWithRootNodeValue:@"root"];
+		CWTree *tree2 = [[CWTree alloc] initWithRootNodeValue:@"root"];
+		[[tree1 rootNode] addChild:[[CWTreeNode alloc] initWithValue:@"Fry"]];
+		[[tree2 rootNode] addChild:[[CWTreeNode alloc] initWithValue:@"Fry"]];
+		
+		expect([tree1 isEqualToTree:tree2]).to.beTruthy();
+		
+		[[[tree2 rootNode] children][0] setValue:@"Leela"];
+		
+		expect([tree1 isEqualToTree:tree2]).to.beFalsy();
+	});
+});
+
+describe(@"-diffWithTree", ^{
+	it(@"should report added, removed & changed nodes", ^{
+		CWTree *tree1 = [[CWTree alloc] initWithRootNodeValue:@"config"];
+		CWTree *tree2 = [[CWTree alloc] initWithRootNodeValue:@"config"];
+		
+		CWTreeNode *timeout1 = [[CWTreeNode alloc] initWithValue:@"timeout"];
+		CWTreeNode *value1 = [[CWTreeNode alloc] initWithValue:@"30"];
+		CWTreeNode *retries = [[CWTreeNode alloc] initWithValue:@"retries"];
+		[timeout1 addChild:value1];
+		[[tree1 rootNode] addChild:timeout1];
+		[[tree1 rootNode] addChild:retries];
+		
+		CWTreeNode *timeout2 = [[CWTreeNode alloc] initWithValue:@"timeout"];
+		CWTreeNode *value2 = [[CWTreeNode alloc] initWithValue:@"60"];
+		CWTreeNode *host = [[CWTreeNode alloc] initWithValue:@"host"];
+		CWTreeNode *port = [[CWTreeNode alloc] initWithValue:@"port"];
+		[timeout2 addChild:value2];
+		[[tree2 rootNode] addChild:timeout2];
+		[[tree2 rootNode] addChild:host];
+		[[tree2 rootNode] addChild:port];
+		
+		CWTreeDiff *diff = [tree1 diffWithTree:tree2];
+		
+		expect([diff.changedNodes objectForKey:value1]).to.equal(value2);
+		expect([diff.changedNodes objectForKey:retries]).to.equal(host);
+		expect(diff.addedNodes).to.equal(@[ port ]);
+		expect(diff.removedNodes.count).to.equal(0);
+	});
+	
+	it(@"should be empty for equal trees", ^{
+		CWTree *tree1 = [[CWTree alloc] initWithRootNodeValue:@"root"];
+		CWTree *tree2 = [[CWTree alloc] initWithRootNodeValue:@"root"];
+		[[tree1 rootNode] addChild:[[CWTreeNode alloc] initWithValue:@"Fry"]];
+		[[tree2 rootNode] addChild:[[CWTreeNode alloc] initWithValue:@"Fry"]];
+		
+		expect([[tree1 diffWithTree:tree2] isEmpty]).to.beTruthy();
+	});
+	
+	it(@"should not skip different subtrees whose hashes collide", ^{
+		CWTree *tree1 = [[CWTree alloc] initWithRootNodeValue:@"root"];
+		CWTree *tree2 = [[CWTree alloc] initWithRootNodeValue:@"root"];
+		CWTreeNode *leela = [[CWTreeNode alloc] initWithValue:[CWTreeCollidingValue valueWithName:@"Leela"]];
+		CWTreeNode *amy = [[CWTreeNode alloc] initWithValue:[CWTreeCollidingValue valueWithName:@"Amy"]];
+		[[tree1 rootNode] addChild:leela];
+		[[tree2 rootNode] addChild:amy];
+		
+		expect([tree1 rootNode].subtreeHash).to.equal([tree2 rootNode].subtreeHash);
+		
+		CWTreeDiff *diff = [tree1 diffWithTree:tree2];
+		
+		expect([diff.changedNodes objectForKey:leela]).to.equal(amy);
+	});
+	
+	it(@"should not report an unchanged nil valued child as changed", ^{
+		CWTree *tree1 = [[CWTree alloc] initWithRootNodeValue:@"root"];
+		CWTree *tree2 = [[CWTree alloc] initWithRootNodeValue:@"root"];
+		CWTreeNode *empty1 = [[CWTreeNode alloc] initWithValue:nil];
+		CWTreeNode *empty2 = [[CWTreeNode alloc] initWithValue:nil];
+		CWTreeNode *fry = [[CWTreeNode alloc] initWithValue:@"Fry"];
+		CWTreeNode *bender = [[CWTreeNode alloc] initWithValue:@"Bender"];
+		CWTreeNode *leela = [[CWTreeNode alloc] initWithValue:@"Leela"];
+		CWTreeNode *amy = [[CWTreeNode alloc] initWithValue:@"Amy"];
+		[empty1 addChild:fry];
+		[empty2 addChild:bender];
+		[[tree1 rootNode] addChild:empty1];
+		[[tree1 rootNode] addChild:leela];
+		[[tree2 rootNode] addChild:empty2];
+		[[tree2 rootNode] addChild:amy];
+		
+		CWTreeDiff *diff = [tree1 diffWithTree:tree2];
+		
+		expect([diff.changedNodes objectForKey:empty1]).to.beNil();
+		expect([diff.changedNodes objectForKey:leela]).to.equal(amy);
+		//the nil valued children are still descended into
+		expect([diff.changedNodes objectForKey:fry]).to.equal(bender);
+		expect(diff.changedNodes.count == 2).to.beTruthy();
+	});
 });
 
 describe(@"-enumerateTreeWithBlock", ^{
@@ -127,6 +246,162 @@ describe(@"-enumerateTreeWithBlock", ^{
 	});
 });
 
+describe(@"-concurrentEnumerateTreeWithBlock", ^{
+	it(@"should visit every node exactly once", ^{
+		CWTree *tree = [[CWTree alloc] initWithRootNodeValue:@0];
+		NSUInteger value = 1;
+		for (NSUInteger i = 0; i < 100; i++) {
+			CWTreeNode *child = [[CWTreeNode alloc] initWithValue:@(value++)];
+			[[tree rootNode] addChild:child];
+			for (NSUInteger j = 0; j < 10; j++) {
+				[child addChild:[[CWTreeNode alloc] initWithValue:@(value++)]];
+			}
+		}
+
+		NSMutableSet *visited = [NSMutableSet set];
+		NSLock *lock = [NSLock new];
+		[tree concurrentEnumerateTreeWithBlock:^(id nodeValue, id node, BOOL *stop) {
+			[lock lock];
+			[visited addObject:nodeValue];
+			[lock unlock];
+		}];
+
+		expect(visited.count).to.equal(value);
+	});
+
+	it(@"should visit every node of a tree too narrow to split up", ^{
+		CWTree *tree = [[CWTree alloc] initWithRootNodeValue:@0];
+		NSArray *tails = @[ [tree rootNode], [tree rootNode] ];
+		NSUInteger value = 1;
+		for (NSUInteger i = 0; i < 100; i++) {
+			NSMutableArray *nextTails = [NSMutableArray array];
+			for (CWTreeNode *tail in tails) {
+				CWTreeNode *node = [[CWTreeNode alloc] initWithValue:@(value++)];
+				[tail addChild:node];
+				[nextTails addObject:node];
+			}
+			tails = nextTails;
+		}
+
+		__block int64_t visited = 0;
+		[tree concurrentEnumerateTreeWithBlock:^(id nodeValue, id node, BOOL *stop) {
+			__atomic_add_fetch(&visited, 1, __ATOMIC_RELAXED);
+		}];
+
+		expect(visited).to.equal(value);
+	});
+});
+
+describe(@"-reduceSubtreesWithBlock", ^{
+	it(@"should pass each node the results of its children", ^{
+		/**
+		 the tree looks like
+		       1
+		   ----|----
+		   2       3
+		 --|--     |
+		 4   5     6
+
+		 summing every subtree should give 21 at the root
+		 */
+		CWTree *tree = [[CWTree alloc] initWithRootNodeValue:@1];
+		CWTreeNode *node2 = [[CWTreeNode alloc] initWithValue:@2];
+		CWTreeNode *node3 = [[CWTreeNode alloc] initWithValue:@3];
+		[[tree rootNode] addChild:node2];
+		[[tree rootNode] addChild:node3];
+		[node2 addChild:[[CWTreeNode alloc] initWithValue:@4]];
+		[node2 addChild:[[CWTreeNode alloc] initWithValue:@5]];
+		[node3 addChild:[[CWTreeNode alloc] initWithValue:@6]];
+
+		NSNumber *sum = [tree reduceSubtreesWithBlock:^id(id nodeValue, CWTreeNode *node, NSArray *childResults) {
+			NSInteger total = [nodeValue integerValue];
+			for (NSNumber *result in childResults) total += result.integerValue;
+			return @(total);
+		}];
+
+		expect(sum).to.equal(@21);
+	});
+
+	it(@"should reduce subtrees split across work items", ^{
+		CWTree *tree = [[CWTree alloc] initWithRootNodeValue:@0];
+		tree.concurrentGrainSize = 1;
+		NSUInteger count = 1;
+		for (NSUInteger i = 0; i < 200; i++) {
+			CWTreeNode *child = [[CWTreeNode alloc] initWithValue:@(count++)];
+			[[tree rootNode] addChild:child];
+			for (NSUInteger j = 0; j < 10; j++) {
+				[child addChild:[[CWTreeNode alloc] initWithValue:@(count++)]];
+			}
+		}
+
+		NSNumber *nodes = [tree reduceSubtreesWithBlock:^id(id nodeValue, CWTreeNode *node, NSArray *childResults) {
+			NSUInteger total = 1;
+			for (NSNumber *result in childResults) total += result.unsignedIntegerValue;
+			return @(total);
+		}];
+
+		expect(nodes).to.equal(@(count));
+	});
+
+	it(@"should return nil for a tree with no root node", ^{
+		CWTree *tree = [[CWTree alloc] init];
+		id result = [tree reduceSubtreesWithBlock:^id(id nodeValue, CWTreeNode *node, NSArray *childResults) {
+			return @1;
+		}];
+
+		expect(result).to.beNil();
+	});
+});
+
+describe(@"value index", ^{
+	it(@"should find values added before and after indexing is turned on", ^{
+		CWTree *tree = [[CWTree alloc] initWithRootNodeValue:@"root"];
+		CWTreeNode *node1 = [[CWTreeNode alloc] initWithValue:@"Fry"];
+		[[tree rootNode] addChild:node1];
+		tree.indexesNodeValues = YES;
+		
+		expect([tree containsObject:@"Fry"]).to.beTruthy();
+		expect([tree containsObject:@"Leela"]).to.beFalsy();
+		
+		CWTreeNode *node2 = [[CWTreeNode alloc] initWithValue:@"Leela"];
+		[node1 addChild:node2];
+		
+		expect([tree containsObject:@"Leela"]).to.beTruthy();
+		expect([tree nodesWithValue:@"Leela"]).to.equal(@[ node2 ]);
+	});
+	
+	it(@"should drop a removed subtree from the index", ^{
+		CWTree *tree = [[CWTree alloc] initWithRootNodeValue:@"root"];
+		tree.indexesNodeValues = YES;
+		CWTreeNode *node1 = [[CWTreeNode alloc] initWithValue:@"Fry"];
+		CWTreeNode *node2 = [[CWTreeNode alloc] initWithValue:@"Leela"];
+		[[tree rootNode] addChild:node1];
+		[node1 addChild:node2];
+		[[tree rootNode] removeChild:node1];
+		
+		expect([tree containsObject:@"Fry"]).to.beFalsy();
+		expect([tree containsObject:@"Leela"]).to.beFalsy();
+	});
+	
+	it(@"should track nodes sharing a value and value changes", ^{
+		CWTree *tree = [[CWTree alloc] initWithRootNodeValue:@"root"];
+		tree.indexesNodeValues = YES;
+		CWTreeNode *node1 = [[CWTreeNode alloc] initWithValue:@"Bender"];
+		CWTreeNode *node2 = [[CWTreeNode alloc] initWithValue:@"Bender"];
+		CWTreeNode *node3 = [[CWTreeNode alloc] initWithValue:@"Zoidberg"];
+		[[tree rootNode] addChild:node1];
+		[[tree rootNode] addChild:node3];
+		[node3 addChild:node2];
+		
+		expect([tree nodesWithValue:@"Bender"].count).to.equal(2);
+		
+		node2.value = @"Hermes";
+		
+		expect([tree nodesWithValue:@"Bender"]).to.equal(@[ node1 ]);
+		expect([tree containsObject:@"Hermes"]).to.beTruthy();
+	});
+});
+
 SpecEnd
 
 SpecBegin(CWTreeNode)
@@ -154,6 +429,63 @@ describe(@"-addChild", ^{
 		
 		expect(node.children.count == 1).to.beTruthy();
 	});
+	
+	it(@"should keep children in insertion order", ^{
+		CWTreeNode *node = [[CWTreeNode alloc] initWithValue:@"root"];
+		[node setAllowsDuplicates:NO];
+		for (NSUInteger i = 0; i < 100; i++) {
+			[node addChild:[[CWTreeNode alloc] initWithValue:@(i)]];
+		}
+		
+		expect(node.children.count).to.equal(100);
+		expect([node.children[42] value]).to.equal(@42);
+	});
+});
+
+describe(@"-childWithValue", ^{
+	it(@"should find children by value and follow value changes", ^{
+		CWTreeNode *node = [[CWTreeNode alloc] initWithValue:@"root"];
+		[node setAllowsDuplicates:NO];
+		CWTreeNode *child = [[CWTreeNode alloc] initWithValue:@"Fry"];
+		[node addChild:child];
+		
+		expect([node childWithValue:@"Fry"]).to.equal(child);
+		expect([node childWithValue:@"Leela"]).to.beNil();
+		
+		child.value = @"Leela";
+		
+		expect([node childWithValue:@"Fry"]).to.beNil();
+		expect([node childWithValue:@"Leela"]).to.equal(child);
+	});
+});
+
+describe(@"-removeChild", ^{
+	it(@"should remove a child and allow its value to be added again", ^{
+		CWTreeNode *node = [[CWTreeNode alloc] initWithValue:@"root"];
+		[node setAllowsDuplicates:NO];
+		CWTreeNode *child = [[CWTreeNode alloc] initWithValue:@"Bender"];
+		[node addChild:child];
+		[node removeChild:child];
+		
+		expect(node.children.count == 0).to.beTruthy();
+		expect(child.parent).to.beNil();
+		
+		CWTreeNode *child2 = [[CWTreeNode alloc] initWithValue:@"Bender"];
+		[node addChild:child2];
+		
+		expect(node.children.count == 1).to.beTruthy();
+	});
+	
+	it(@"should ignore nodes that are not children", ^{
+		CWTreeNode *node = [[CWTreeNode alloc] initWithValue:@"root"];
+		[node setAllowsDuplicates:NO];
+		CWTreeNode *child = [[CWTreeNode alloc] initWithValue:@"Bender"];
+		CWTreeNode *stranger = [[CWTreeNode alloc] initWithValue:@"Bender"];
+		[node addChild:child];
+		[node removeChild:stranger];
+		
+		expect(node.children.count == 1).to.beTruthy();
+	});
 });
 
 describe(@"-nodeLevel", ^{
@@ -167,6 +499,86 @@ describe(@"-nodeLevel", ^{
 		
 		expect(node2.nodeLevel == 2).to.beTruthy();
 	});
+	
+	it(@"should update the levels of a moved subtree", ^{
+		CWTreeNode *node1 = [[CWTreeNode alloc] initWithValue:@"1"];
+		CWTreeNode *node2 = [[CWTreeNode alloc] initWithValue:@"2"];
+		CWTreeNode *node3 = [[CWTreeNode alloc] initWithValue:@"3"];
+		CWTreeNode *node4 = [[CWTreeNode alloc] initWithValue:@"4"];
+		[node1 addChild:node2];
+		[node3 addChild:node4];
+		[node2 addChild:node3];
+		
+		expect(node4.nodeLevel == 4).to.beTruthy();
+		
+		[node2 removeChild:node3];
+		
+		expect(node3.nodeLevel == 1).to.beTruthy();
+		expect(node4.nodeLevel == 2).to.beTruthy();
+	});
+});
+
+describe(@"ancestry", ^{
+	/**
+	 builds a chain of 100 nodes with a second branch hanging off node 50
+	 */
+	NSMutableArray *chain = [NSMutableArray array];
+	CWTreeNode *root = [[CWTreeNode alloc] initWithValue:@0];
+	[chain addObject:root];
+	for (NSUInteger i = 1; i < 100; i++) {
+		CWTreeNode *node = [[CWTreeNode alloc] initWithValue:@(i)];
+		[(CWTreeNode *)[chain lastObject] addChild:node];
+		[chain addObject:node];
+	}
+	CWTreeNode *branch = [[CWTreeNode alloc] initWithValue:@"branch"];
+	[(CWTreeNode *)chain[50] addChild:branch];
+	CWTreeNode *leaf = [[CWTreeNode alloc] initWithValue:@"leaf"];
+	[branch addChild:leaf];
+	
+	it(@"should answer -isAncestorOf correctly", ^{
+		expect([root isAncestorOf:chain[99]]).to.beTruthy();
+		expect([chain[50] isAncestorOf:leaf]).to.beTruthy();
+		expect([chain[51] isAncestorOf:leaf]).to.beFalsy();
+		expect([chain[99] isAncestorOf:root]).to.beFalsy();
+		expect([root isAncestorOf:root]).to.beFalsy();
+	});
+	
+	it(@"should find the lowest common ancestor", ^{
+		expect([leaf lowestCommonAncestorWith:chain[99]]).to.equal(chain[50]);
+		expect([chain[99] lowestCommonAncestorWith:chain[20]]).to.equal(chain[20]);
+		expect([leaf lowestCommonAncestorWith:leaf]).to.equal(leaf);
+		
+		CWTreeNode *stranger = [[CWTreeNode alloc] initWithValue:@"stranger"];
+		expect([leaf lowestCommonAncestorWith:stranger]).to.beNil();
+	});
+	
+	it(@"should make a node that outlives its tree a root", ^{
+		CWTreeNode *grandchild = nil;
+		CWTreeNode *greatGrandchild = nil;
+		@autoreleasepool {
+			CWTree *tree = [[CWTree alloc] initWithRootNodeValue:@"root"];
+			CWTreeNode *child = [[CWTreeNode alloc] initWithValue:@"child"];
+			[tree.rootNode addChild:child];
+			grandchild = [[CWTreeNode alloc] initWithValue:@"grandchild"];
+			[child addChild:grandchild];
+			greatGrandchild = [[CWTreeNode alloc] initWithValue:@"great grandchild"];
+			[grandchild addChild:greatGrandchild];
+			expect(greatGrandchild.nodeLevel == 4).to.beTruthy();
+		}
+		
+		expect(grandchild.parent).to.beNil();
+		expect(grandchild.nodeLevel == 1).to.beTruthy();
+		expect(greatGrandchild.nodeLevel == 2).to.beTruthy();
+		expect([grandchild isAncestorOf:greatGrandchild]).to.beTruthy();
+		expect([greatGrandchild isAncestorOf:grandchild]).to.beFalsy();
+		expect([greatGrandchild lowestCommonAncestorWith:grandchild]).to.equal(grandchild);
+		
+		CWTreeNode *newChild = [[CWTreeNode alloc] initWithValue:@"new child"];
+		[grandchild addChild:newChild];
+		expect(newChild.nodeLevel == 2).to.beTruthy();
+		expect([grandchild isAncestorOf:newChild]).to.beTruthy();
+		expect([greatGrandchild lowestCommonAncestorWith:newChild]).to.equal(grandchild);
+	});
 });
 
 SpecEnd
@@ -29,15 +29,17 @@
  */
 
 #import <Foundation/Foundation.h>
+#import "CWStatistics.h"
 
 /**
  CWTrie
  
  CWTrie is a Trie Data Structure that is built with pure Objective-C and is
- thread safe. It uses a serial dispatch_queue_t to perform all operations to
- ensure that they are executed serially. The set method is asynchronous, but all
- get methods (objectValueForKey,containsKey,etc.) are synchronous. Optionally
- it can be set so that the keys are case sensitive, but by default they are not.
+ thread safe. It takes a lock embedded in the instance around all operations
+ to ensure that they are executed serially, all methods are synchronous.
+ Optionally it can be set so that the keys are case sensitive, but by default
+ they are not. Tries only used from one thread at a time can be created
+ without synchronization to skip locking entirely.
  */
 
 @interface CWTrie : NSObject
@@ -57,6 +59,23 @@
  */
 -(instancetype)initWithCaseSensitiveKeys:(BOOL)caseSensitive;
 
+/**
+ Initializes & returns a new CWTrie instance
+ 
+ @param caseSensitive sets if the trie instace should use case sensitive keys
+ @param synchronized if YES the trie locks around every operation & is safe to
+ use from multiple threads, this is what the other initializers do. If NO the
+ trie does no locking & must only be used from one thread at a time.
+ @return An initialized CWTrie instance
+ */
+-(instancetype)initWithCaseSensitiveKeys:(BOOL)caseSensitive
+                            synchronized:(BOOL)synchronized;
+
+/**
+ Returns if the trie was created with synchronization
+ */
+@property(readonly, getter=isSynchronized) BOOL synchronized;
+
 /**
  Sets a key value pair in the trie
  
@@ -90,4 +109,21 @@
  */
 -(void)removeObjectValueForKey:(NSString *)key;
 
+#if CW_STATISTICS
+
+/**
+ Returns the statistics the trie has kept since it was created
+ 
+ The dictionary contains setCount, removeCount, lookupCount, cacheHitCount &
+ cacheMissCount (how many lookups were answered by the cache of recently used
+ values), containsKeyCount, nodeCount (nodes created for keys) & waitTime, a
+ histogram of the time each call waited for the trie's lock. Only available
+ when CW_STATISTICS is set to 1.
+ 
+ @return a NSDictionary with the trie's statistics
+ */
+-(NSDictionary *)statistics;
+
+#endif
+
 @end
@@ -29,8 +29,8 @@
  */
 
 #import "CWTrie.h"
-#import <libkern/OSAtomic.h>
 #import "CWAssertionMacros.h"
+#import "CWLock.h"
 
 #define kCWTrieCacheLimit 2
 
@@ -96,80 +96,96 @@
 
 @end
 
-@interface CWTrie ()
+#if CW_STATISTICS
+typedef struct CWTrieStatistics {
+    uint64_t setCount;
+    uint64_t removeCount;
+    uint64_t lookupCount;
+    uint64_t cacheHitCount;
+    uint64_t cacheMissCount;
+    uint64_t containsKeyCount;
+    uint64_t nodeCount;
+    CWStatisticsWaitHistogram wait;
+} CWTrieStatistics;
+#endif
+
+@interface CWTrie () {
+    CWLock _lock;
+#if CW_STATISTICS
+    CWTrieStatistics _statistics;
+#endif
+}
 @property(assign) BOOL caseSensitive;
 @property(strong) CWTrieNode *root;
-@property(strong) dispatch_queue_t queue;
 @property(strong) NSCache *cache; //for holding the last value looked up by -containsKey
 @end
 
-static int64_t queue_counter = 0;
+#define CWTrieLock() CWLockAcquire(&_lock, _synchronized, _statistics.wait)
+#define CWTrieUnlock() CWLockRelease(&_lock, _synchronized)
 
 @implementation CWTrie
 
 -(instancetype)init {
-    self = [super init];
-    if(!self) return self;
-    
-    _root = [CWTrieNode new];
-    _caseSensitive = NO;
-    _cache = [NSCache new];
-    [_cache setCountLimit:kCWTrieCacheLimit];
-    _queue = ({
-        NSString *label = [NSString stringWithFormat:@"%@%lli",
-                           NSStringFromClass([self class]),
-                           OSAtomicIncrement64(&queue_counter)];
-        dispatch_queue_t aQueue = dispatch_queue_create([label UTF8String], DISPATCH_QUEUE_SERIAL);
-        aQueue;
-    });
-    
-    return self;
+    return [self initWithCaseSensitiveKeys:NO synchronized:YES];
 }
 
 -(instancetype)initWithCaseSensitiveKeys:(BOOL)caseSensitive {
+    return [self initWithCaseSensitiveKeys:caseSensitive synchronized:YES];
+}
+
+-(instancetype)initWithCaseSensitiveKeys:(BOOL)caseSensitive
+                            synchronized:(BOOL)synchronized {
     self = [super init];
     if(!self) return self;
     
     _root = [CWTrieNode new];
-    _cache = [NSCache new];
-    [_cache setCountLimit:kCWTrieCacheLimit];
     _caseSensitive = caseSensitive;
-    _queue = ({
-        NSString *label = [NSString stringWithFormat:@"%@%lli",
-                           NSStringFromClass([self class]),
-                           OSAtomicIncrement64(&queue_counter)];
-        dispatch_queue_t aQueue = dispatch_queue_create([label UTF8String], DISPATCH_QUEUE_SERIAL);
-        aQueue;
-    });
+    _synchronized = synchronized;
+    CWLockInit(&_lock);
+    //the cache is created by the first value stored, empty tries don't pay for it
+    _cache = nil;
     
     return self;
 }
 
+-(void)dealloc {
+    CWLockDestroy(&_lock);
+}
+
 -(void)setObjectValue:(id)value
                forKey:(NSString *)key {
     CWAssert(value != nil);
     CWAssert((key != nil) && (key.length >= 1));
     
-    __weak CWTrieNode *weakRoot = self.root;
-    __weak NSCache *weakCache = self.cache;
-    dispatch_async(self.queue, ^{
-        const char *keyValue = CWTrieKey();
-        CWTrieNode *search = weakRoot;
-        NSCache *scache = weakCache;
-        
-        while (*keyValue) {
-            char sc = *keyValue;
-            CWTrieNode *nextNode = [search nodeForKeyValue:sc];
-            search = nextNode ?: [search setNodeForKeyValue:sc];
-            keyValue++;
+    CWTrieLock();
+    CWStatisticsCount(_statistics.setCount);
+    const char *keyValue = CWTrieKey();
+    CWTrieNode *search = self.root;
+    
+    while (*keyValue) {
+        char sc = *keyValue;
+        CWTrieNode *nextNode = [search nodeForKeyValue:sc];
+        if (nextNode == nil) {
+            nextNode = [search setNodeForKeyValue:sc];
+            CWStatisticsCount(_statistics.nodeCount);
         }
-        search.storedValue = value;
-        [scache setObject:value forKey:key];
-    });
+        search = nextNode;
+        keyValue++;
+    }
+    search.storedValue = value;
+    if (self.cache == nil) {
+        self.cache = [NSCache new];
+        [self.cache setCountLimit:kCWTrieCacheLimit];
+    }
+    [self.cache setObject:value forKey:key];
+    CWTrieUnlock();
 }
 
 -(void)removeObjectValueForKey:(NSString *)key {
     CWAssert((key != nil) && (key.length >= 1));
+    
+    CWTrieLock();
+    CWStatisticsCount(_statistics.removeCount);
     //remove object from cache if it exists
     [self.cache removeObjectForKey:key];
     /*
@@ -178,86 +194,96 @@ static int64_t queue_counter = 0;
      doesn't exist in the trie instance.) If it reaches its intended node it
      sets the storedValue to nil, otherwise its just sending a message to nil.
      */
-    __weak CWTrieNode *weakRoot = self.root;
-    dispatch_async(self.queue, ^{
-        const char *keyValue = CWTrieKey();
-        CWTrieNode *search = weakRoot;
-        while (*keyValue && (search != nil)) {
-            search = [search nodeForKeyValue:*keyValue];
-            keyValue++;
-        }
-        search.storedValue = nil;
-    });
+    const char *keyValue = CWTrieKey();
+    CWTrieNode *search = self.root;
+    while (*keyValue && (search != nil)) {
+        search = [search nodeForKeyValue:*keyValue];
+        keyValue++;
+    }
+    search.storedValue = nil;
+    CWTrieUnlock();
 }
 
 -(BOOL)containsKey:(NSString *)key {
     CWAssert((key != nil) && (key.length >= 1));
     
-    __block BOOL contains = YES;
-    __weak CWTrieNode *weakRoot = self.root;
-    __weak CWTrie *weakSelf = self;
-    dispatch_sync(self.queue, ^{
-        CWTrie *sself = weakSelf;
-        CWTrieNode *node = weakRoot;
-        const char *theKey = CWTrieKey();
-        while (*theKey) {
-            node = [node nodeForKeyValue:*theKey];
-            if(node == nil) {
-                contains = NO;
-                break;
-            }
-            theKey++;
-        }
-        /*
-         we know that the key exists here in that we've enumerated over the
-         chars in the string we were given and they exist, but that doesn't
-         necessarily mean there is a node stored here. i.e. if someone stores
-         an object for the key @"hello" does the key @"he" exist? the nodes for
-         it exist but we need to check for a node value
-         */
-        if(node && (node.storedValue != nil)) {
-            /* this is convenient so you can do
-             if([trie containsKey:key]) {
-             id obj = [trie objectValueForKey:key];
-             ...
-             }
-             and we won't have to lookup the same value twice
-             */
-            [sself.cache setObject:node.storedValue forKey:key];
-        } else {
+    BOOL contains = YES;
+    CWTrieLock();
+    CWStatisticsCount(_statistics.containsKeyCount);
+    CWTrieNode *node = self.root;
+    const char *theKey = CWTrieKey();
+    while (*theKey) {
+        node = [node nodeForKeyValue:*theKey];
+        if(node == nil) {
             contains = NO;
+            break;
         }
-    });
+        theKey++;
+    }
+    /*
+     we know that the key exists here in that we've enumerated over the
+     chars in the string we were given and they exist, but that doesn't
+     necessarily mean there is a node stored here. i.e. if someone stores
+     an object for the key @"hello" does the key @"he" exist? the nodes for
+     it exist but we need to check for a node value
+     */
+    if(node && (node.storedValue != nil)) {
+        /* this is convenient so you can do
+         if([trie containsKey:key]) {
+         id obj = [trie objectValueForKey:key];
+         ...
+         }
+         and we won't have to lookup the same value twice
+         */
+        [self.cache setObject:node.storedValue forKey:key];
+    } else {
+        contains = NO;
+    }
+    CWTrieUnlock();
     return contains;
 }
 
 -(id)objectValueForKey:(NSString *)key {
     CWAssert((key != nil) && (key.length >= 1));
     
-    __block id result = nil;
-    __weak CWTrieNode *wroot = self.root;
-    __weak NSCache *weakCache = self.cache;
-    
-    dispatch_sync(self.queue, ^{
-        NSCache *trieCache = weakCache;
-        //check the cache first
-        id obj = [trieCache objectForKey:key];
-        if (obj) {
-            result = obj;
-            return;
-        }
+    CWTrieLock();
+    CWStatisticsCount(_statistics.lookupCount);
+    //check the cache first
+    id result = [self.cache objectForKey:key];
+    if (result) {
+        CWStatisticsCount(_statistics.cacheHitCount);
+    } else {
+        CWStatisticsCount(_statistics.cacheMissCount);
         
         //object not in the cache... do the normal search...
-        CWTrieNode *node = wroot;
+        CWTrieNode *node = self.root;
         const char *keystr = CWTrieKey();
         while (*keystr && (node != nil)) {
             node = [node nodeForKeyValue:*keystr];
             keystr++;
         }
         result = node.storedValue;
-    });
+    }
+    CWTrieUnlock();
     
     return result;
 }
 
+#if CW_STATISTICS
+
+#pragma mark Statistics -
+
+-(NSDictionary *)statistics {
+    return @{ @"setCount" : @(CWStatisticsLoad(&_statistics.setCount)),
+              @"removeCount" : @(CWStatisticsLoad(&_statistics.removeCount)),
+              @"lookupCount" : @(CWStatisticsLoad(&_statistics.lookupCount)),
+              @"cacheHitCount" : @(CWStatisticsLoad(&_statistics.cacheHitCount)),
+              @"cacheMissCount" : @(CWStatisticsLoad(&_statistics.cacheMissCount)),
+              @"containsKeyCount" : @(CWStatisticsLoad(&_statistics.containsKeyCount)),
+              @"nodeCount" : @(CWStatisticsLoad(&_statistics.nodeCount)),
+              @"waitTime" : CWStatisticsWaitHistogramDictionary(&_statistics.wait) };
+}
+
+#endif
+
 @end
@@ -113,6 +113,21 @@ describe(@"cache tests", ^{
     });
 });
 
+describe(@"-initWithCaseSensitiveKeys:synchronized:", ^{
+    it(@"should behave the same without synchronization", ^{
+        CWTrie *trie = [[CWTrie alloc] initWithCaseSensitiveKeys:YES synchronized:NO];
+        
+        expect(trie.isSynchronized).to.beFalsy();
+        expect([CWTrie new].isSynchronized).to.beTruthy();
+        
+        [trie setObjectValue:@1 forKey:@"Fry"];
+        
+        expect([trie containsKey:@"Fry"]).to.beTruthy();
+        expect([trie containsKey:@"fry"]).to.beFalsy();
+        expect([trie objectValueForKey:@"Fry"]).to.equal(@1);
+    });
+});
+
 describe(@"removeObjectForKey", ^{
     NSString * const kObjectKey = @"Hypnotoad";
     
@@ -127,4 +142,28 @@ describe(@"removeObjectForKey", ^{
     expect([trie objectValueForKey:kObjectKey]).to.beNil();
 });
 
+#if CW_STATISTICS
+
+describe(@"-statistics", ^{
+    it(@"should count cache hits & misses", ^{
+        CWTrie *trie = [CWTrie new];
+        [trie setObjectValue:@1 forKey:@"ab"];
+        [trie setObjectValue:@2 forKey:@"ac"];
+        [trie setObjectValue:@3 forKey:@"bd"];
+        [trie setObjectValue:@4 forKey:@"be"];
+        [trie removeObjectValueForKey:@"ac"];
+        //the cache only holds the most recent values so this may or may not hit
+        expect([trie objectValueForKey:@"ab"]).to.equal(@1);
+        
+        NSDictionary *statistics = trie.statistics;
+        expect(statistics[@"setCount"]).to.equal(@4);
+        expect(statistics[@"removeCount"]).to.equal(@1);
+        expect(statistics[@"lookupCount"]).to.equal(@1);
+        expect([statistics[@"cacheHitCount"] integerValue] + [statistics[@"cacheMissCount"] integerValue] == 1).to.beTruthy();
+        expect(statistics[@"nodeCount"]).to.equal(@6);
+    });
+});
+
+#endif
+
 SpecEnd
@@ -0,0 +1,124 @@
+/*
+//  CWWorkStealingDeque.h
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+  /*
+ This class should not make any use of the Zangetsu Framework API's so it can
+ retain its independence and be used in other projects not making use of the
+ Zangetsu Framework.
+  */
+
+#import <Foundation/Foundation.h>
+
+/**
+ CWWorkStealingDeque is a Chase-Lev work stealing deque
+ 
+ Each deque has one owner thread, which pushes & pops objects at the top of the
+ deque like a CWStack. Any number of other threads may steal objects from the
+ bottom of the deque at the same time. None of the operations take a lock:
+ push & pop only touch memory the owner thread uses until the deque is nearly
+ empty, and steals race each other (and the owners last pop) with a single
+ compare & swap.
+ 
+ This is the building block for a fork-join task scheduler: give each worker
+ thread a deque, have workers push the tasks they spawn & pop their own work
+ depth first, and have idle workers steal the oldest (usually largest) tasks
+ from other workers deques.
+ 
+ The deque grows as needed, old storage is only freed once no steal can still
+ be reading it. Calling -pushObject: or -popObject from any thread other than
+ the owner is undefined behavior. The owner is whichever thread uses them, it
+ doesn't have to be the thread that created the deque.
+ */
+
+@interface CWWorkStealingDeque : NSObject
+
+/**
+ Initializes an empty deque with room for capacity objects before it grows
+ 
+ -init uses a capacity of 64.
+ 
+ @param capacity the number of objects the deque can hold before growing, it
+ is rounded up to a power of 2
+ @return an initialized CWWorkStealingDeque object
+ */
+-(instancetype)initWithCapacity:(NSUInteger)capacity;
+
+/**
+ Pushes object onto the top of the deque, owner thread only
+ 
+ @param object the object to push, if nil this method does nothing
+ */
+-(void)pushObject:(id)object;
+
+/**
+ Pops the object at the top of the deque, owner thread only
+ 
+ This returns the object most recently pushed that hasn't been popped or
+ stolen yet.
+ 
+ @return the object at the top of the deque or nil if the deque is empty
+ */
+-(id)popObject;
+
+/**
+ Steals the object at the bottom of the deque, safe from any thread
+ 
+ This returns the oldest object in the deque. If another thread stole or
+ popped that object at the same moment this method gives up & returns nil
+ rather than retrying, a scheduler will usually want to try another deque
+ instead. Use -isEmpty to tell an empty deque apart from a lost race.
+ 
+ @return the object at the bottom of the deque or nil if the deque is empty or
+ the steal lost a race with another thread
+ */
+-(id)stealObject;
+
+/**
+ Returns the number of objects in the deque
+ 
+ When other threads are pushing, popping or stealing this is only a snapshot
+ which may already be out of date when it returns.
+ 
+ @return a NSUInteger with the number of objects in the deque
+ */
+-(NSUInteger)count;
+
+/**
+ Returns a BOOL indicating if the deque is empty
+ 
+ Like -count this is only a snapshot when other threads are using the deque.
+ 
+ @return YES if the deque has no objects, otherwise NO
+ */
+-(BOOL)isEmpty;
+
+@end
@@ -0,0 +1,242 @@
+/*
+//  CWWorkStealingDeque.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWWorkStealingDeque.h"
+#import "CWAssertionMacros.h"
+
+#define kCWWorkStealingDequeDefaultCapacity 64
+
+/**
+ The deques circular array. capacity is always a power of 2 so wrapping an
+ index is a mask. Slots hold objects retained by -pushObject:, the retain is
+ handed to whoever pops or steals the object. retired links arrays that have
+ been replaced by a bigger one but may still be read by a steal in progress.
+ */
+typedef struct CWWorkStealingDequeArray {
+	int64_t capacity;
+	struct CWWorkStealingDequeArray *retired;
+	void *slots[];
+} CWWorkStealingDequeArray;
+
+static CWWorkStealingDequeArray *CWWorkStealingDequeArrayCreate(int64_t capacity) {
+	CWWorkStealingDequeArray *array = calloc(1, sizeof(CWWorkStealingDequeArray) + ((size_t)capacity * sizeof(void *)));
+	CWAssert(array != NULL);
+	array->capacity = capacity;
+	return array;
+}
+
+static inline void *CWWorkStealingDequeArrayGet(CWWorkStealingDequeArray *array, int64_t index) {
+	return __atomic_load_n(&array->slots[index & (array->capacity - 1)], __ATOMIC_RELAXED);
+}
+
+static inline void CWWorkStealingDequeArraySet(CWWorkStealingDequeArray *array, int64_t index, void *object) {
+	__atomic_store_n(&array->slots[index & (array->capacity - 1)], object, __ATOMIC_RELAXED);
+}
+
+/*
+ Naming note: the Chase-Lev paper calls the owners end "bottom" & the thieves
+ end "top". Here they are named after the CWStack convention instead, _top is
+ the owners end (the index the next push goes in) & _bottom is the thieves end
+ (the index of the oldest object). The deque holds the objects in
+ [_bottom, _top). The memory orderings follow Le, Pop, Cohen & Zappa Nardelli
+ "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ 
+ Reclamation: a thief loads _array & then reads a slot from it, so an array
+ the owner replaced can't be freed while a thief might be between those two
+ steps. Thieves count themselves in _activeThieves around that window & the
+ owner only frees retired arrays when it sees the count at 0. Because the new
+ array is published before the count is read (both sequentially consistent)
+ any thief that wasn't counted will load the new array.
+ */
+
+@interface CWWorkStealingDeque () {
+	int64_t _top;
+	int64_t _bottom;
+	CWWorkStealingDequeArray *_array;
+	CWWorkStealingDequeArray *_retired;
+	uint64_t _activeThieves;
+}
+@end
+
+@implementation CWWorkStealingDeque
+
+#pragma mark Initialization -
+
+-(instancetype)init {
+	return [self initWithCapacity:kCWWorkStealingDequeDefaultCapacity];
+}
+
+-(instancetype)initWithCapacity:(NSUInteger)capacity {
+	self = [super init];
+	if (self == nil) return nil;
+	
+	int64_t arrayCapacity = 2;
+	while ((NSUInteger)arrayCapacity < capacity) arrayCapacity *= 2;
+	_array = CWWorkStealingDequeArrayCreate(arrayCapacity);
+	_retired = NULL;
+	_top = 0;
+	_bottom = 0;
+	_activeThieves = 0;
+	
+	return self;
+}
+
+-(void)dealloc {
+	for (int64_t index = _bottom; index < _top; index++) {
+		id object __unused = (__bridge_transfer id)CWWorkStealingDequeArrayGet(_array, index);
+	}
+	[self _freeRetiredArrays];
+	free(_array);
+}
+
+#pragma mark Storage -
+
+/**
+ Replaces _array with one twice the size holding the same objects, owner only.
+ The old array is retired rather than freed since a thief may be reading it.
+ */
+-(CWWorkStealingDequeArray *)_growArray:(CWWorkStealingDequeArray *)array
+								 bottom:(int64_t)bottom
+									top:(int64_t)top {
+	CWWorkStealingDequeArray *grown = CWWorkStealingDequeArrayCreate(array->capacity * 2);
+	for (int64_t index = bottom; index < top; index++) {
+		CWWorkStealingDequeArraySet(grown, index, CWWorkStealingDequeArrayGet(array, index));
+	}
+	__atomic_store_n(&_array, grown, __ATOMIC_SEQ_CST);
+	array->retired = _retired;
+	_retired = array;
+	[self _reclaimRetiredArrays];
+	return grown;
+}
+
+/**
+ Frees the retired arrays if no thief can be reading one, owner only
+ */
+-(void)_reclaimRetiredArrays {
+	if (_retired == NULL) return;
+	if (__atomic_load_n(&_activeThieves, __ATOMIC_SEQ_CST) != 0) return;
+	[self _freeRetiredArrays];
+}
+
+-(void)_freeRetiredArrays {
+	while (_retired != NULL) {
+		CWWorkStealingDequeArray *next = _retired->retired;
+		free(_retired);
+		_retired = next;
+	}
+}
+
+#pragma mark Owner Operations -
+
+-(void)pushObject:(id)object {
+	if (object == nil) return;
+	
+	int64_t top = __atomic_load_n(&_top, __ATOMIC_RELAXED);
+	int64_t bottom = __atomic_load_n(&_bottom, __ATOMIC_ACQUIRE);
+	CWWorkStealingDequeArray *array = __atomic_load_n(&_array, __ATOMIC_RELAXED);
+	if ((top - bottom) > (array->capacity - 1)) {
+		array = [self _growArray:array bottom:bottom top:top];
+	}
+	CWWorkStealingDequeArraySet(array, top, (__bridge_retained void *)object);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	__atomic_store_n(&_top, top + 1, __ATOMIC_RELAXED);
+}
+
+-(id)popObject {
+	int64_t top = __atomic_load_n(&_top, __ATOMIC_RELAXED) - 1;
+	CWWorkStealingDequeArray *array = __atomic_load_n(&_array, __ATOMIC_RELAXED);
+	__atomic_store_n(&_top, top, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	int64_t bottom = __atomic_load_n(&_bottom, __ATOMIC_RELAXED);
+	
+	void *object = NULL;
+	if (bottom <= top) {
+		object = CWWorkStealingDequeArrayGet(array, top);
+		if (bottom == top) {
+			//last object, race the thieves for it
+			if (!__atomic_compare_exchange_n(&_bottom, &bottom, bottom + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+				object = NULL;
+			}
+			__atomic_store_n(&_top, top + 1, __ATOMIC_RELAXED);
+		}
+	} else {
+		__atomic_store_n(&_top, top + 1, __ATOMIC_RELAXED);
+	}
+	
+	[self _reclaimRetiredArrays];
+	return (__bridge_transfer id)object;
+}
+
+#pragma mark Thief Operations -
+
+-(id)stealObject {
+	__atomic_fetch_add(&_activeThieves, 1, __ATOMIC_SEQ_CST);
+	
+	int64_t bottom = __atomic_load_n(&_bottom, __ATOMIC_ACQUIRE);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	int64_t top = __atomic_load_n(&_top, __ATOMIC_ACQUIRE);
+	
+	void *object = NULL;
+	if (bottom < top) {
+		CWWorkStealingDequeArray *array = __atomic_load_n(&_array, __ATOMIC_SEQ_CST);
+		object = CWWorkStealingDequeArrayGet(array, bottom);
+		if (!__atomic_compare_exchange_n(&_bottom, &bottom, bottom + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+			//lost to the owner or another thief, the object isn't ours
+			object = NULL;
+		}
+	}
+	
+	__atomic_fetch_sub(&_activeThieves, 1, __ATOMIC_RELEASE);
+	return (__bridge_transfer id)object;
+}
+
+#pragma mark Query Methods -
+
+-(NSUInteger)count {
+	int64_t bottom = __atomic_load_n(&_bottom, __ATOMIC_ACQUIRE);
+	int64_t top = __atomic_load_n(&_top, __ATOMIC_ACQUIRE);
+	return (top > bottom) ? (NSUInteger)(top - bottom) : 0;
+}
+
+-(BOOL)isEmpty {
+	return ([self count] == 0);
+}
+
+#pragma mark Debug Information -
+
+-(NSString *)description {
+	return [NSString stringWithFormat:@"<%@: %p> count %lu capacity %lld",
+			NSStringFromClass([self class]), (__bridge void *)self,
+			(unsigned long)[self count], (long long)__atomic_load_n(&_array, __ATOMIC_RELAXED)->capacity];
+}
+
+@end
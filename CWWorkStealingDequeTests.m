@@ -0,0 +1,131 @@
+/*
+//  CWWorkStealingDequeTests.m
+//  Zangetsu Data Structures
+//
+//  Created by Colin Wheeler on 10/18/26.
+//  Copyright (c) 2026 Colin Wheeler. All rights reserved.
+//
+ Copyright (c) 2013, Colin Wheeler
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ - Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "CWWorkStealingDeque.h"
+
+SpecBegin(CWWorkStealingDeque)
+
+describe(@"-popObject", ^{
+	it(@"should pop objects in reverse order", ^{
+		CWWorkStealingDeque *deque = [CWWorkStealingDeque new];
+		[deque pushObject:@"Fry"];
+		[deque pushObject:@"Leela"];
+		[deque pushObject:@"Bender"];
+		
+		expect([deque popObject]).to.equal(@"Bender");
+		expect([deque popObject]).to.equal(@"Leela");
+		expect([deque popObject]).to.equal(@"Fry");
+		expect([deque popObject]).to.beNil();
+	});
+	
+	it(@"should not push nil", ^{
+		CWWorkStealingDeque *deque = [CWWorkStealingDeque new];
+		id object = nil;
+		[deque pushObject:object];
+		
+		expect(deque.isEmpty).to.beTruthy();
+	});
+});
+
+describe(@"-stealObject", ^{
+	it(@"should steal objects in the order they were pushed", ^{
+		CWWorkStealingDeque *deque = [CWWorkStealingDeque new];
+		[deque pushObject:@"Fry"];
+		[deque pushObject:@"Leela"];
+		[deque pushObject:@"Bender"];
+		
+		expect([deque stealObject]).to.equal(@"Fry");
+		expect([deque popObject]).to.equal(@"Bender");
+		expect([deque stealObject]).to.equal(@"Leela");
+		expect([deque stealObject]).to.beNil();
+		expect(deque.isEmpty).to.beTruthy();
+	});
+});
+
+describe(@"growing", ^{
+	it(@"should keep its objects when it grows past its capacity", ^{
+		CWWorkStealingDeque *deque = [[CWWorkStealingDeque alloc] initWithCapacity:2];
+		NSUInteger stolen = 0;
+		for (NSUInteger i = 0; i < 100; i++) {
+			[deque pushObject:@(i)];
+			if (i % 10 == 0) expect([deque stealObject]).to.equal(@(stolen++));
+		}
+		
+		expect(deque.count == 90).to.beTruthy();
+		expect([deque popObject]).to.equal(@99);
+		expect([deque stealObject]).to.equal(@10);
+	});
+});
+
+it(@"should hand each object to exactly one thread while being stolen from", ^{
+	CWWorkStealingDeque *deque = [[CWWorkStealingDeque alloc] initWithCapacity:2];
+	NSUInteger total = 100000;
+	NSUInteger thieves = 4;
+	NSMutableArray *taken = [NSMutableArray array];
+	for (NSUInteger t = 0; t <= thieves; t++) [taken addObject:[NSMutableArray array]];
+	__block BOOL ownerDone = NO;
+	
+	dispatch_group_t group = dispatch_group_create();
+	for (NSUInteger t = 0; t < thieves; t++) {
+		NSMutableArray *stolen = taken[t];
+		dispatch_group_async(group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+			while (!__atomic_load_n(&ownerDone, __ATOMIC_ACQUIRE) || !deque.isEmpty) {
+				id object = [deque stealObject];
+				if (object) [stolen addObject:object];
+			}
+		});
+	}
+	
+	NSMutableArray *popped = taken[thieves];
+	for (NSUInteger i = 0; i < total; i++) {
+		[deque pushObject:@(i)];
+		if (i % 3 == 0) {
+			id object = [deque popObject];
+			if (object) [popped addObject:object];
+		}
+	}
+	id object = nil;
+	while ((object = [deque popObject]) != nil) [popped addObject:object];
+	__atomic_store_n(&ownerDone, YES, __ATOMIC_RELEASE);
+	dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+	
+	NSMutableSet *seen = [NSMutableSet set];
+	NSUInteger count = 0;
+	for (NSArray *objects in taken) {
+		[seen addObjectsFromArray:objects];
+		count += objects.count;
+	}
+	expect(count == total).to.beTruthy();
+	expect(seen.count == total).to.beTruthy();
+});
+
+SpecEnd